@@ -1,16 +1,21 @@
 #ifndef DPSINTERFACEMODEL_H
 #define DPSINTERFACEMODEL_H
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
-struct InitSimulationParams;
+struct SweepDefinition;
 
 class DPSInterfacePresenter;
 class InitFileGenerator;
 class InitFileSimulator;
 class OutFileProcessor;
+class RunCostModel;
+class SweepCoordinator;
+class SweepJournal;
+class SweepPipeline;
 
 class DPSInterfaceModel {
 
@@ -19,10 +24,30 @@ public:
                     std::string const &directory);
   ~DPSInterfaceModel();
 
+  void updateSweepSeed(std::uint64_t sweepSeed);
   void updateNumberOfBodies(std::size_t numberOfBodies);
   void updateHasSinglePlanet(bool hasSinglePlanet);
   void updateCombinePlanetResults(bool combineResults);
   void updateUseDefaultHeaderParams(bool useDefaults);
+  void updateUsePackedFiles(bool usePackedFiles);
+  void updateNumberOfIntegrators(std::size_t numberOfIntegrators);
+  void updateDeleteOutFiles(bool deleteOutFiles);
+  void updateResumeSweep(bool resumeSweep);
+  void updateIntegratorBackend(std::size_t backendIndex);
+  void updateEarlyTerminationWindow(std::size_t earlyTerminationWindow);
+  void updateWallTimeLimit(std::size_t wallTimeLimit);
+  void updateCpuTimeLimit(std::size_t cpuTimeLimit);
+  void updateMemoryLimit(std::size_t memoryLimit);
+  void updateStallTimeLimit(std::size_t stallTimeLimit);
+  void updateMaximumRetries(std::size_t maximumRetries);
+  void updateCoordinatorAddress(std::string const &coordinatorAddress);
+  void updateNumberOfShards(std::size_t numberOfShards);
+  void updateMockTimeSteps(std::size_t mockTimeSteps);
+  void updateMockLatency(std::size_t mockLatency);
+  void updateReplayDirectory(std::string const &replayDirectory);
+  void updateWriteOrbitalElements(bool writeOrbitalElements);
+  void updateBootstrapResamples(std::size_t bootstrapResamples);
+  void updateResultsFormat(std::size_t formatIndex);
   void updateTimeStep(double timeStep);
   void updateNumberOfTimeSteps(std::size_t numberOfTimeSteps);
   void updateTrueAnomaly(double trueAnomaly);
@@ -46,24 +71,30 @@ private:
               std::vector<std::string> const &planetDistancesB,
               std::size_t numberOfOrientation) const;
 
-  bool generateInitFiles(std::vector<std::string> const &pericentres,
-                         std::vector<std::string> const &planetDistancesA,
-                         std::vector<std::string> const &planetDistancesB,
-                         std::size_t numberOfOrientation) const;
-
-  bool simulateInitFiles(
-      std::vector<InitSimulationParams> const &simParameters) const;
-  void
-  processOutFiles(std::vector<InitSimulationParams> const &simParameters) const;
+  bool openJournal() const;
+  bool generateInitFiles(SweepDefinition const &sweep) const;
+  bool simulateInitFiles(SweepDefinition const &sweep) const;
+  void processOutFiles(SweepDefinition const &sweep) const;
+  void runPipeline(SweepDefinition const &sweep) const;
+  void writeShardManifests(SweepDefinition const &sweep) const;
+#ifdef __linux__
+  void runCoordinator(SweepDefinition const &sweep) const;
+#endif
 
   template <typename Process>
   bool runProcess(Process const &predicate,
                   std::string const &processDescription) const;
 
   std::string m_directory;
+  std::unique_ptr<SweepJournal> m_journal;
+  std::unique_ptr<RunCostModel> m_costModel;
   std::unique_ptr<InitFileGenerator> m_initFileGenerator;
   std::unique_ptr<InitFileSimulator> m_initFileSimulator;
   std::unique_ptr<OutFileProcessor> m_outFileProcessor;
+  std::unique_ptr<SweepPipeline> m_sweepPipeline;
+#ifdef __linux__
+  std::unique_ptr<SweepCoordinator> m_sweepCoordinator;
+#endif
   DPSInterfacePresenter *m_presenter;
 };
 
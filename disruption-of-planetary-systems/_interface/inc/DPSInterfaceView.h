@@ -2,6 +2,7 @@
 #define DPSINTERFACEVIEW_H
 #include "ui_DPSInterfaceView.h"
 
+#include <cstdint>
 #include <string>
 
 #include <QString>
@@ -16,9 +17,29 @@ public:
   ~DPSInterfaceView();
 
   std::string directory() const;
+  std::uint64_t sweepSeed() const;
   std::size_t numberOfBodies() const;
   bool combinePlanetResults() const;
   bool useDefaultHeaderParams() const;
+  bool usePackedFiles() const;
+  std::size_t numberOfIntegrators() const;
+  bool deleteOutFiles() const;
+  bool resumeSweep() const;
+  std::size_t integratorBackend() const;
+  std::size_t earlyTerminationWindow() const;
+  std::size_t wallTimeLimit() const;
+  std::size_t cpuTimeLimit() const;
+  std::size_t memoryLimit() const;
+  std::size_t stallTimeLimit() const;
+  std::size_t maximumRetries() const;
+  std::string coordinatorAddress() const;
+  std::size_t numberOfShards() const;
+  std::size_t mockTimeSteps() const;
+  std::size_t mockLatency() const;
+  std::string replayDirectory() const;
+  bool writeOrbitalElements() const;
+  std::size_t bootstrapResamples() const;
+  std::size_t resultsFormat() const;
   double timeStep() const;
   std::size_t numberOfTimeSteps() const;
   double trueAnomaly() const;
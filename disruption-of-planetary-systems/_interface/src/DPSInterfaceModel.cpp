@@ -4,7 +4,13 @@
 #include "GenerateInitFiles.h"
 #include "InitSimulationParams.h"
 #include "ProcessOutFiles.h"
+#include "RunCostModel.h"
 #include "SimulateInitFiles.h"
+#include "SimulationParamsStream.h"
+#include "SweepCoordinator.h"
+#include "SweepJournal.h"
+#include "SweepPipeline.h"
+#include "SweepShards.h"
 
 #include "Logger.h"
 #include "PerformanceChecker.h"
@@ -29,20 +35,36 @@ std::vector<std::string> splitStringByDelimiter(std::string const &str,
 DPSInterfaceModel::DPSInterfaceModel(DPSInterfacePresenter *presenter,
                                      std::string const &directory)
     : m_presenter(presenter), m_directory(directory),
-      m_initFileGenerator(std::make_unique<InitFileGenerator>(m_directory)),
-      m_outFileProcessor(std::make_unique<OutFileProcessor>(m_directory)) {
+      m_journal(std::make_unique<SweepJournal>(m_directory)),
+      m_costModel(std::make_unique<RunCostModel>(m_directory)),
+      m_initFileGenerator(
+          std::make_unique<InitFileGenerator>(m_directory, *m_journal)),
+      m_outFileProcessor(
+          std::make_unique<OutFileProcessor>(m_directory, *m_journal)) {
   setupInitFileSimulator();
+  m_sweepPipeline = std::make_unique<SweepPipeline>(
+      m_directory, *m_initFileGenerator, *m_outFileProcessor, *m_journal,
+      *m_costModel);
+#ifdef __linux__
+  m_sweepCoordinator =
+      std::make_unique<SweepCoordinator>(*m_journal, *m_outFileProcessor);
+#endif
 }
 
 DPSInterfaceModel::~DPSInterfaceModel() {}
 
 void DPSInterfaceModel::setupInitFileSimulator() {
   auto const subStrings = splitStringByDelimiter(m_directory, ":");
-  auto const drive = subStrings[0] + ":";
-  auto subDirectory = subStrings[1];
+  // A directory without a drive letter is an absolute POSIX path
+  auto const drive = subStrings.size() > 1 ? subStrings[0] + ":" : "";
+  auto subDirectory = subStrings.back();
   subDirectory.erase(0, 1);
   m_initFileSimulator =
-      std::make_unique<InitFileSimulator>(drive, subDirectory);
+      std::make_unique<InitFileSimulator>(drive, subDirectory, *m_journal);
+}
+
+void DPSInterfaceModel::updateSweepSeed(std::uint64_t sweepSeed) {
+  OtherSimulationSettings::m_sweepSeed = sweepSeed;
 }
 
 void DPSInterfaceModel::updateNumberOfBodies(std::size_t numberOfBodies) {
@@ -62,6 +84,91 @@ void DPSInterfaceModel::updateUseDefaultHeaderParams(bool useDefaults) {
   OtherSimulationSettings::m_useDefaults = useDefaults;
 }
 
+void DPSInterfaceModel::updateUsePackedFiles(bool usePackedFiles) {
+  OtherSimulationSettings::m_usePackedFiles = usePackedFiles;
+}
+
+void DPSInterfaceModel::updateNumberOfIntegrators(
+    std::size_t numberOfIntegrators) {
+  OtherSimulationSettings::m_numberOfIntegrators = numberOfIntegrators;
+}
+
+void DPSInterfaceModel::updateDeleteOutFiles(bool deleteOutFiles) {
+  OtherSimulationSettings::m_deleteOutFiles = deleteOutFiles;
+}
+
+void DPSInterfaceModel::updateResumeSweep(bool resumeSweep) {
+  OtherSimulationSettings::m_resumeSweep = resumeSweep;
+}
+
+void DPSInterfaceModel::updateIntegratorBackend(std::size_t backendIndex) {
+  OtherSimulationSettings::m_integratorBackend =
+      static_cast<IntegratorBackend>(backendIndex);
+}
+
+void DPSInterfaceModel::updateEarlyTerminationWindow(
+    std::size_t earlyTerminationWindow) {
+  OtherSimulationSettings::m_earlyTerminationWindow = earlyTerminationWindow;
+}
+
+void DPSInterfaceModel::updateWallTimeLimit(std::size_t wallTimeLimit) {
+  OtherSimulationSettings::m_wallTimeLimit = wallTimeLimit;
+}
+
+void DPSInterfaceModel::updateCpuTimeLimit(std::size_t cpuTimeLimit) {
+  OtherSimulationSettings::m_cpuTimeLimit = cpuTimeLimit;
+}
+
+void DPSInterfaceModel::updateMemoryLimit(std::size_t memoryLimit) {
+  OtherSimulationSettings::m_memoryLimit = memoryLimit;
+}
+
+void DPSInterfaceModel::updateStallTimeLimit(std::size_t stallTimeLimit) {
+  OtherSimulationSettings::m_stallTimeLimit = stallTimeLimit;
+}
+
+void DPSInterfaceModel::updateMaximumRetries(std::size_t maximumRetries) {
+  OtherSimulationSettings::m_maximumRetries = maximumRetries;
+}
+
+void DPSInterfaceModel::updateCoordinatorAddress(
+    std::string const &coordinatorAddress) {
+  OtherSimulationSettings::m_coordinatorAddress = coordinatorAddress;
+}
+
+void DPSInterfaceModel::updateNumberOfShards(std::size_t numberOfShards) {
+  OtherSimulationSettings::m_numberOfShards = numberOfShards;
+}
+
+void DPSInterfaceModel::updateMockTimeSteps(std::size_t mockTimeSteps) {
+  OtherSimulationSettings::m_mockTimeSteps = mockTimeSteps;
+}
+
+void DPSInterfaceModel::updateMockLatency(std::size_t mockLatency) {
+  OtherSimulationSettings::m_mockLatency = mockLatency;
+}
+
+void DPSInterfaceModel::updateReplayDirectory(
+    std::string const &replayDirectory) {
+  OtherSimulationSettings::m_replayDirectory = replayDirectory;
+  if (!replayDirectory.empty() && replayDirectory.back() != '/')
+    OtherSimulationSettings::m_replayDirectory += '/';
+}
+
+void DPSInterfaceModel::updateWriteOrbitalElements(bool writeOrbitalElements) {
+  OtherSimulationSettings::m_writeOrbitalElements = writeOrbitalElements;
+}
+
+void DPSInterfaceModel::updateBootstrapResamples(
+    std::size_t bootstrapResamples) {
+  OtherSimulationSettings::m_bootstrapResamples = bootstrapResamples;
+}
+
+void DPSInterfaceModel::updateResultsFormat(std::size_t formatIndex) {
+  OtherSimulationSettings::m_resultsFormat =
+      static_cast<ResultsFormat>(formatIndex);
+}
+
 void DPSInterfaceModel::updateTimeStep(double timeStep) {
   InitHeaderData::m_fixedHeaderParams->m_timeStep = timeStep;
 }
@@ -125,42 +232,97 @@ void DPSInterfaceModel::runAll(std::vector<std::string> const &pericentres,
                                std::vector<std::string> const &planetDistancesA,
                                std::vector<std::string> const &planetDistancesB,
                                std::size_t numberOfOrientation) const {
-  if (generateInitFiles(pericentres, planetDistancesA, planetDistancesB,
-                        numberOfOrientation)) {
-    auto const simParameters = m_initFileGenerator->simulationParameters();
-    if (simulateInitFiles(simParameters))
-      processOutFiles(simParameters);
+  SweepDefinition sweep(pericentres, planetDistancesA, planetDistancesB,
+                        numberOfOrientation);
+  m_costModel->load();
+  if (OtherSimulationSettings::m_numberOfShards > 0) {
+    writeShardManifests(sweep);
+    return;
+  }
+
+  if (!openJournal())
+    return;
+  sweep.orderCellsByCost(*m_costModel);
+
+#ifdef __linux__
+  if (OtherSimulationSettings::m_coordinatorAddress.empty())
+    runPipeline(sweep);
+  else
+    runCoordinator(sweep);
+#else
+  if (OtherSimulationSettings::m_integratorBackend ==
+      IntegratorBackend::External) {
+    if (generateInitFiles(sweep) && simulateInitFiles(sweep))
+      processOutFiles(sweep);
+  } else {
+    runPipeline(sweep);
   }
+#endif
+  m_journal->close();
+  m_costModel->save();
 }
 
-bool DPSInterfaceModel::generateInitFiles(
-    std::vector<std::string> const &pericentres,
-    std::vector<std::string> const &planetDistancesA,
-    std::vector<std::string> const &planetDistancesB,
-    std::size_t numberOfOrientation) const {
+bool DPSInterfaceModel::openJournal() const {
+  auto const openProcess = [&]() {
+    m_journal->open(OtherSimulationSettings::m_resumeSweep);
+    return true;
+  };
+  return runProcess(openProcess, "Opening the sweep journal");
+}
+
+bool DPSInterfaceModel::generateInitFiles(SweepDefinition const &sweep) const {
   auto const generateProcess = [&]() {
-    return m_initFileGenerator->generate(pericentres, planetDistancesA,
-                                         planetDistancesB, numberOfOrientation);
+    return m_initFileGenerator->generate(sweep);
   };
   return runProcess(generateProcess, "Generating init files");
 }
 
-bool DPSInterfaceModel::simulateInitFiles(
-    std::vector<InitSimulationParams> const &simParameters) const {
+bool DPSInterfaceModel::simulateInitFiles(SweepDefinition const &sweep) const {
   auto const simulationProcess = [&]() {
-    return m_initFileSimulator->simulateInitFiles(simParameters);
+    return m_initFileSimulator->simulateInitFiles(sweep);
   };
   return runProcess(simulationProcess, "Simulating init files");
 }
 
-void DPSInterfaceModel::processOutFiles(
-    std::vector<InitSimulationParams> const &simParameters) const {
+void DPSInterfaceModel::processOutFiles(SweepDefinition const &sweep) const {
   auto const dataAnalysisProcess = [&]() {
-    return m_outFileProcessor->performAnalysis(simParameters);
+    return m_outFileProcessor->performAnalysis(sweep);
   };
   (void)runProcess(dataAnalysisProcess, "Processing out files");
 }
 
+void DPSInterfaceModel::runPipeline(SweepDefinition const &sweep) const {
+  auto const pipelineProcess = [&]() { return m_sweepPipeline->run(sweep); };
+  (void)runProcess(pipelineProcess, "Running the simulations");
+}
+
+void DPSInterfaceModel::writeShardManifests(
+    SweepDefinition const &sweep) const {
+  auto const numberOfShards = OtherSimulationSettings::m_numberOfShards;
+  auto const manifestProcess = [&]() {
+    SweepShards::writeManifests(sweep, *m_costModel, numberOfShards,
+                                m_directory);
+    return true;
+  };
+  if (runProcess(manifestProcess, "Writing the shard manifests"))
+    Logger::getInstance().addLog(
+        LogType::Info,
+        "Wrote " + std::to_string(numberOfShards) +
+            " shard manifests. Run each with --shard <manifest> <directory> "
+            "and merge their partial_results.txt files with --merge "
+            "<directory> <partial results>...");
+}
+
+#ifdef __linux__
+void DPSInterfaceModel::runCoordinator(SweepDefinition const &sweep) const {
+  auto const coordinatorProcess = [&]() {
+    return m_sweepCoordinator->run(
+        sweep, OtherSimulationSettings::m_coordinatorAddress);
+  };
+  (void)runProcess(coordinatorProcess, "Coordinating the workers");
+}
+#endif
+
 template <typename Process>
 bool DPSInterfaceModel::runProcess(
     Process const &process, std::string const &processDescription) const {
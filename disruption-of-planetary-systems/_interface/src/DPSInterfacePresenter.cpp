@@ -12,9 +12,29 @@ DPSInterfacePresenter::DPSInterfacePresenter(DPSInterfaceView *view,
 DPSInterfacePresenter::~DPSInterfacePresenter() {}
 
 void DPSInterfacePresenter::setInitHeaderParams() {
+  m_model->updateSweepSeed(m_view->sweepSeed());
   m_model->updateNumberOfBodies(m_view->numberOfBodies());
   m_model->updateCombinePlanetResults(m_view->combinePlanetResults());
   m_model->updateUseDefaultHeaderParams(m_view->useDefaultHeaderParams());
+  m_model->updateUsePackedFiles(m_view->usePackedFiles());
+  m_model->updateNumberOfIntegrators(m_view->numberOfIntegrators());
+  m_model->updateDeleteOutFiles(m_view->deleteOutFiles());
+  m_model->updateResumeSweep(m_view->resumeSweep());
+  m_model->updateIntegratorBackend(m_view->integratorBackend());
+  m_model->updateEarlyTerminationWindow(m_view->earlyTerminationWindow());
+  m_model->updateWallTimeLimit(m_view->wallTimeLimit());
+  m_model->updateCpuTimeLimit(m_view->cpuTimeLimit());
+  m_model->updateMemoryLimit(m_view->memoryLimit());
+  m_model->updateStallTimeLimit(m_view->stallTimeLimit());
+  m_model->updateMaximumRetries(m_view->maximumRetries());
+  m_model->updateCoordinatorAddress(m_view->coordinatorAddress());
+  m_model->updateNumberOfShards(m_view->numberOfShards());
+  m_model->updateMockTimeSteps(m_view->mockTimeSteps());
+  m_model->updateMockLatency(m_view->mockLatency());
+  m_model->updateReplayDirectory(m_view->replayDirectory());
+  m_model->updateWriteOrbitalElements(m_view->writeOrbitalElements());
+  m_model->updateBootstrapResamples(m_view->bootstrapResamples());
+  m_model->updateResultsFormat(m_view->resultsFormat());
   m_model->updateTimeStep(m_view->timeStep());
   m_model->updateNumberOfTimeSteps(m_view->numberOfTimeSteps());
   m_model->updateTrueAnomaly(m_view->trueAnomaly());
@@ -68,6 +68,10 @@ std::string DPSInterfaceView::directory() const {
   return m_ui.leDirectory->text().toStdString();
 }
 
+std::uint64_t DPSInterfaceView::sweepSeed() const {
+  return static_cast<std::uint64_t>(m_ui.sbSweepSeed->value());
+}
+
 std::size_t DPSInterfaceView::numberOfBodies() const {
   return static_cast<std::size_t>(m_ui.sbNumberOfBodies->value());
 }
@@ -80,6 +84,82 @@ bool DPSInterfaceView::useDefaultHeaderParams() const {
   return m_ui.ckUseDefaultHeaderParameters->isChecked();
 }
 
+bool DPSInterfaceView::usePackedFiles() const {
+  return m_ui.ckUsePackedFiles->isChecked();
+}
+
+std::size_t DPSInterfaceView::numberOfIntegrators() const {
+  return static_cast<std::size_t>(m_ui.sbNumberOfIntegrators->value());
+}
+
+bool DPSInterfaceView::deleteOutFiles() const {
+  return m_ui.ckDeleteOutFiles->isChecked();
+}
+
+bool DPSInterfaceView::resumeSweep() const {
+  return m_ui.ckResumeSweep->isChecked();
+}
+
+std::size_t DPSInterfaceView::integratorBackend() const {
+  return static_cast<std::size_t>(m_ui.cbIntegrator->currentIndex());
+}
+
+std::size_t DPSInterfaceView::earlyTerminationWindow() const {
+  return static_cast<std::size_t>(m_ui.sbEarlyTerminationWindow->value());
+}
+
+std::size_t DPSInterfaceView::wallTimeLimit() const {
+  return static_cast<std::size_t>(m_ui.sbWallTimeLimit->value());
+}
+
+std::size_t DPSInterfaceView::cpuTimeLimit() const {
+  return static_cast<std::size_t>(m_ui.sbCpuTimeLimit->value());
+}
+
+std::size_t DPSInterfaceView::memoryLimit() const {
+  return static_cast<std::size_t>(m_ui.sbMemoryLimit->value());
+}
+
+std::size_t DPSInterfaceView::stallTimeLimit() const {
+  return static_cast<std::size_t>(m_ui.sbStallTimeLimit->value());
+}
+
+std::size_t DPSInterfaceView::maximumRetries() const {
+  return static_cast<std::size_t>(m_ui.sbMaximumRetries->value());
+}
+
+std::string DPSInterfaceView::coordinatorAddress() const {
+  return m_ui.leCoordinatorAddress->text().trimmed().toStdString();
+}
+
+std::size_t DPSInterfaceView::numberOfShards() const {
+  return static_cast<std::size_t>(m_ui.sbNumberOfShards->value());
+}
+
+std::size_t DPSInterfaceView::mockTimeSteps() const {
+  return static_cast<std::size_t>(m_ui.sbMockTimeSteps->value());
+}
+
+std::size_t DPSInterfaceView::mockLatency() const {
+  return static_cast<std::size_t>(m_ui.sbMockLatency->value());
+}
+
+std::string DPSInterfaceView::replayDirectory() const {
+  return m_ui.leReplayDirectory->text().trimmed().toStdString();
+}
+
+bool DPSInterfaceView::writeOrbitalElements() const {
+  return m_ui.ckWriteOrbitalElements->isChecked();
+}
+
+std::size_t DPSInterfaceView::bootstrapResamples() const {
+  return static_cast<std::size_t>(m_ui.sbBootstrapResamples->value());
+}
+
+std::size_t DPSInterfaceView::resultsFormat() const {
+  return static_cast<std::size_t>(m_ui.cbResultsFormat->currentIndex());
+}
+
 double DPSInterfaceView::timeStep() const { return m_ui.sbTimeStep->value(); }
 
 std::size_t DPSInterfaceView::numberOfTimeSteps() const {
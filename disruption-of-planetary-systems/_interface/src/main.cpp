@@ -1,8 +1,69 @@
 #include "DPSInterface.h"
+#include "SweepShards.h"
+
+#ifdef __linux__
+#include "SweepWorker.h"
+#endif
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include <QtWidgets/QApplication>
 
+namespace {
+
+std::string directoryArgument(std::string directory) {
+  if (directory.empty())
+    throw std::runtime_error("The directory must not be empty.");
+  if (directory.back() != '/')
+    directory += '/';
+  return directory;
+}
+
+/*
+Runs without the interface when started as a worker or batch job:
+  --worker <address> <directory> [integrators]
+  --shard <manifest> <directory>
+  --merge <directory> <partial results>...
+*/
+int runHeadless(std::vector<std::string> const &arguments) {
+  auto const &command = arguments[0];
+  try {
+#ifdef __linux__
+    if (command == "--worker") {
+      SweepWorker(directoryArgument(arguments[2]))
+          .run(arguments[1],
+               arguments.size() > 3 ? std::stoul(arguments[3]) : 0);
+      return 0;
+    }
+#endif
+    if (command == "--shard")
+      return SweepShards::runShard(arguments[1],
+                                   directoryArgument(arguments[2]))
+                 ? 0
+                 : 1;
+    if (command == "--merge") {
+      SweepShards::mergeShards({arguments.begin() + 2, arguments.end()},
+                               directoryArgument(arguments[1]));
+      return 0;
+    }
+  } catch (std::exception const &error) {
+    std::cerr << command.substr(2) << " stopped: " << error.what()
+              << std::endl;
+    return 1;
+  }
+  std::cerr << "Unknown command " << command << std::endl;
+  return 1;
+}
+
+} // namespace
+
 int main(int argc, char *argv[]) {
+  if (argc >= 4 && std::string(argv[1]).rfind("--", 0) == 0)
+    return runHeadless(std::vector<std::string>(argv + 1, argv + argc));
+
   QApplication a(argc, argv);
   DPSInterface w;
   w.show();
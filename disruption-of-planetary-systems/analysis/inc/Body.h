@@ -1,7 +1,7 @@
 #ifndef BODY_H
 #define BODY_H
 
-#include <vector>
+#include "Trajectory.h"
 
 struct XYZComponents;
 
@@ -9,11 +9,11 @@ class Body {
 public:
   Body(double mass, XYZComponents const &position,
        XYZComponents const &velocity);
-  Body(double mass, std::vector<XYZComponents> const &positions,
-       std::vector<XYZComponents> const &velocities);
+  Body(double mass, Trajectory &&trajectory);
   ~Body();
 
   double mass() const;
+  Trajectory const &trajectory() const;
   XYZComponents position(std::size_t index) const;
   XYZComponents velocity(std::size_t index) const;
 
@@ -30,8 +30,7 @@ public:
 
 private:
   double m_mass;
-  std::vector<XYZComponents> m_positions;
-  std::vector<XYZComponents> m_velocities;
+  Trajectory m_trajectory;
 };
 
 #endif /* BODY_H */
@@ -3,8 +3,12 @@
 
 #include <memory>
 #include <string>
+#include <vector>
+
+struct InitSimulationParams;
 
 class Body;
+class RandomStream;
 
 namespace BodyCreator {
 
@@ -18,6 +22,12 @@ std::unique_ptr<Body const> createPlanet(Body const &star,
                                          std::size_t phi,
                                          std::size_t inclination);
 
+double randomizeTrueAnomaly(double pericentre, double planetDistance,
+                            RandomStream const &randomStream);
+
+std::vector<std::unique_ptr<Body const>>
+createBodies(InitSimulationParams const &parameters);
+
 } // namespace BodyCreator
 
 #endif /* BODY_CREATOR_H */
@@ -0,0 +1,26 @@
+#ifndef BOUNDENERGYTRACKER_H
+#define BOUNDENERGYTRACKER_H
+
+/*
+Tracks whether a body is bound to another from the series of their total
+energies. The body is bound if every energy from the lowest point after the
+highest point onwards is negative. The energies are added one time step at a
+time so that the same criterion can be applied while a trajectory is still
+being written.
+*/
+class BoundEnergyTracker {
+public:
+  BoundEnergyTracker();
+  ~BoundEnergyTracker();
+
+  void addEnergy(double energy);
+  bool isBound() const;
+
+private:
+  bool m_hasEnergies;
+  double m_maximumEnergy;
+  double m_minimumAfterMaximum;
+  bool m_negativeSinceMinimum;
+};
+
+#endif /* BOUNDENERGYTRACKER_H */
@@ -0,0 +1,31 @@
+#ifndef ELEMENTDISTRIBUTION_H
+#define ELEMENTDISTRIBUTION_H
+
+#include "Histogram.h"
+#include "QuantileSketch.h"
+
+/*
+The distribution of an orbital element over the runs of a cell, summarised in
+constant memory by its quantiles and a histogram. Semi-major axes are binned in
+their logarithm and eccentricities between zero and one.
+*/
+class ElementDistribution {
+public:
+  static ElementDistribution semiMajorAxes();
+  static ElementDistribution eccentricities();
+  ~ElementDistribution();
+
+  void add(double value);
+  void merge(ElementDistribution const &otherDistribution);
+
+  QuantileSketch const &quantiles() const;
+  Histogram const &histogram() const;
+
+private:
+  ElementDistribution(Histogram const &histogram);
+
+  QuantileSketch m_quantiles;
+  Histogram m_histogram;
+};
+
+#endif /* ELEMENTDISTRIBUTION_H */
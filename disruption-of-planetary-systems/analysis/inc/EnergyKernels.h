@@ -0,0 +1,45 @@
+#ifndef ENERGY_KERNELS_H
+#define ENERGY_KERNELS_H
+
+#include "SimulationConstants.h"
+
+#include <cmath>
+#include <cstddef>
+
+class Trajectory;
+
+/*
+Computes the total energy of a body relative to another over a range of time
+steps of their trajectories. The widest vector instructions supported by the
+processor are chosen the first time the energies are computed, with a scalar
+kernel used elsewhere. Every kernel performs the same correctly rounded
+operations in the same order as the scalar kernel, without fused multiply-adds,
+so that they all give the same energies. The instruction set can be limited to
+compare the kernels.
+*/
+namespace EnergyKernels {
+
+enum class InstructionSet { Scalar, AVX2, AVX512 };
+
+InstructionSet supportedInstructionSet();
+InstructionSet instructionSet();
+void limitInstructionSet(InstructionSet limit);
+char const *instructionSetName(InstructionSet instructionSet);
+
+// The energy from the separation and relative velocity of the bodies
+inline double totalEnergy(double dx, double dy, double dz, double dvx,
+                          double dvy, double dvz, double targetMass,
+                          double otherMass) {
+  auto const r = std::sqrt(dx * dx + dy * dy + dz * dz);
+  auto const v = std::sqrt(dvx * dvx + dvy * dvy + dvz * dvz);
+  return 0.5 * targetMass * (v * v) -
+         SimulationConstants::G * otherMass * targetMass / r;
+}
+
+void totalEnergies(Trajectory const &target, Trajectory const &other,
+                   std::size_t first, std::size_t count, double targetMass,
+                   double otherMass, double *energies);
+
+} // namespace EnergyKernels
+
+#endif /* ENERGY_KERNELS_H */
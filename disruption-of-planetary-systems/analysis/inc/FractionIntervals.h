@@ -0,0 +1,36 @@
+#ifndef FRACTIONINTERVALS_H
+#define FRACTIONINTERVALS_H
+
+#include <array>
+#include <cstddef>
+
+class RandomStream;
+
+/*
+The bounds of a 95% confidence interval on a fraction
+*/
+struct FractionInterval {
+  double m_lower;
+  double m_upper;
+};
+
+/*
+Confidence intervals on the fractions of the runs of a cell that end bound to
+the black hole, bound to the star and unbound. Wilson score intervals stay
+within zero and one for small counts and for fractions near either. Bootstrap
+intervals resample the outcomes of the runs, each resample drawn from its own
+range of counters of a random stream so that the intervals do not depend on
+the thread they are computed on.
+*/
+namespace FractionIntervals {
+
+FractionInterval wilsonInterval(std::size_t count, std::size_t totalCount);
+
+std::array<FractionInterval, 3>
+bootstrapIntervals(RandomStream const &randomStream, std::size_t bhBoundCount,
+                   std::size_t starBoundCount, std::size_t totalCount,
+                   std::size_t numberOfResamples);
+
+} // namespace FractionIntervals
+
+#endif /* FRACTIONINTERVALS_H */
@@ -1,112 +1,63 @@
 #ifndef GENERATEINITFILES_H
 #define GENERATEINITFILES_H
 
+#include <functional>
 #include <memory>
+#include <ostream>
 #include <string>
-#include <vector>
 
 struct InitHeaderParams;
 struct InitHeaderDefaults;
 struct InitSimulationParams;
+struct SweepDefinition;
 
+class AsyncFileWriter;
 class Body;
-class FileManager;
+class PackedFileWriter;
+class SimulationParamsStream;
+class SweepJournal;
 class TaskRunner;
 
 class InitFileGenerator {
 
 public:
-  InitFileGenerator(std::string const &directory);
-  ~InitFileGenerator();
+  // Called from several generator threads at once, so it must be thread safe
+  using InitRecordHandler = std::function<void(
+      InitSimulationParams const &parameters, std::string &&initRecord)>;
 
-  std::vector<InitSimulationParams> const &simulationParameters() const;
+  InitFileGenerator(std::string const &directory, SweepJournal &journal);
+  ~InitFileGenerator();
 
-  bool generate(std::vector<std::string> const &pericentres,
-                std::vector<std::string> const &planetDistancesA,
-                std::vector<std::string> const &planetDistancesB,
-                std::size_t numberOfOrientations);
+  bool generate(SweepDefinition const &sweep);
+  bool generate(SweepDefinition const &sweep,
+                InitRecordHandler const &recordHandler);
 
 private:
   void resetGenerator(std::size_t numberOfInitFiles);
-  void resetInitSimulationParams(std::size_t numberOfInitFiles);
-  void addInitSimulationParams(InitSimulationParams const &simParameters);
-
-  bool generateInitFiles(std::vector<std::string> const &pericentres,
-                         std::vector<std::string> const &planetDistancesA,
-                         std::vector<std::string> const &planetDistancesB,
-                         std::size_t numberOfOrientations);
-  void generateInitFiles(std::string const &pericentre,
-                         std::vector<std::string> const &planetDistancesA,
-                         std::vector<std::string> const &planetDistancesB,
-                         std::size_t planetDistanceIndex,
-                         std::size_t numberOfOrientations);
-
-  void generate3BodyInitFiles(std::string const &pericentre,
-                              std::string const &planetDistance,
-                              std::size_t numberOfOrientations);
-  void generate3BodyInitFile(std::string const &pericentre,
-                             std::string const &planetDistance,
-                             std::size_t orientationIndex);
-  void generate3BodyInitFile(std::string const &pericentre,
-                             std::string const &planetDistance,
-                             std::size_t orientationIndex, std::size_t phi,
-                             std::size_t inclination);
-  void generate3BodyInitFile(std::string const &filename, double pericentre,
-                             double planetDistance,
-                             std::size_t orientationIndex, std::size_t phi,
-                             std::size_t inclination);
+  void resetInitFileWriter();
 
-  void generate4BodyInitFiles(std::string const &pericentre,
-                              std::string const &planetDistanceA,
-                              std::string const &planetDistanceB,
-                              std::size_t numberOfOrientations);
-  void generate4BodyInitFile(std::string const &pericentre,
-                             std::string const &planetDistanceA,
-                             std::string const &planetDistanceB,
-                             std::size_t orientationIndex);
-  void generate4BodyInitFile(std::string const &pericentre,
-                             std::string const &planetDistanceA,
-                             std::string const &planetDistanceB,
-                             std::size_t orientationIndex, std::size_t phi,
-                             std::size_t inclination);
-  void generate4BodyInitFile(std::string const &filename, double pericentre,
-                             double planetDistanceA, double planetDistanceB,
-                             std::size_t orientationIndex, std::size_t phi,
-                             std::size_t inclination);
+  bool generateInitFiles(SweepDefinition const &sweep);
+  void generateInitFiles(SimulationParamsStream &parametersStream);
+  void writeSimulationParameters(SimulationParamsStream &parametersStream,
+                                 std::ostream &parametersFile) const;
 
-  void createFile(std::string const &filename,
-                  std::string const &fileText) const;
+  void generateInitFile(InitSimulationParams const &parameters) const;
 
-  std::string
-  generate3BodyInitFilename(std::string const &pericentre,
-                            std::string const &planetDistance,
-                            std::size_t const &orientationIndex) const;
-  std::string
-  generate4BodyInitFilename(std::string const &pericentre,
-                            std::string const &planetDistanceA,
-                            std::string const &planetDistanceB,
-                            std::size_t const &orientationIndex) const;
+  std::string acquireBuffer() const;
+  void writeInitFile(InitSimulationParams const &parameters,
+                     std::string &&fileText) const;
 
-  std::string generateInitHeader(std::string const &filename, double pericentre,
-                                 double planetDistance) const;
-
-  void saveSimulationParameters(
-      std::vector<InitSimulationParams> const &parameters) const;
-  std::string generateSimulationParametersText(
-      std::vector<InitSimulationParams> const &parameters) const;
-  std::string generateSimulationParametersHeader(
-      std::vector<InitSimulationParams> const &parameters) const;
+  std::string generateSimulationParametersHeader() const;
   std::string generateSimulationParametersLine(
       InitSimulationParams const &parameters) const;
   std::string generateSimulationPlanetDistancesSubLine(
       InitSimulationParams const &parameters) const;
 
-  double randomizeTrueAnomaly(double pericentre, double planetDistance) const;
-
-  std::vector<InitSimulationParams> m_simulationParams;
-
-  std::unique_ptr<FileManager> m_fileManager;
+  std::unique_ptr<PackedFileWriter> m_initPack;
+  std::unique_ptr<AsyncFileWriter> m_initFileWriter;
+  InitRecordHandler m_recordHandler;
   std::string m_directory;
+  SweepJournal &m_journal;
   TaskRunner &m_taskRunner;
 };
 
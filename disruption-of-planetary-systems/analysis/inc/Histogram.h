@@ -0,0 +1,40 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <cstdint>
+#include <vector>
+
+enum class HistogramScale { Linear, Logarithmic };
+
+/*
+Counts values in fixed bins spaced evenly, or evenly in their logarithm, between
+a minimum and a maximum. Values outside the bins are counted as underflows or
+overflows, so histograms with the same bins can be merged by adding counts.
+*/
+class Histogram {
+public:
+  Histogram(double minimum, double maximum, std::size_t numberOfBins,
+            HistogramScale scale);
+  ~Histogram();
+
+  void add(double value);
+  void merge(Histogram const &otherHistogram);
+
+  std::size_t numberOfBins() const;
+  double binEdge(std::size_t index) const;
+  std::vector<std::uint64_t> const &binCounts() const;
+  std::uint64_t underflow() const;
+  std::uint64_t overflow() const;
+
+private:
+  double scaled(double value) const;
+
+  double m_minimum;
+  double m_maximum;
+  HistogramScale m_scale;
+  std::vector<std::uint64_t> m_binCounts;
+  std::uint64_t m_underflow;
+  std::uint64_t m_overflow;
+};
+
+#endif /* HISTOGRAM_H */
@@ -0,0 +1,39 @@
+#ifndef INIT_FILE_SERIALIZER_H
+#define INIT_FILE_SERIALIZER_H
+
+#include <string>
+
+struct InitSimulationParams;
+
+class Body;
+
+/*
+Formats the contents of .init files into a caller owned buffer. Floating point
+values are written using their shortest round-trip representation. A time step
+divisor shortens the time step of a run while keeping its duration.
+*/
+namespace InitFileSerializer {
+
+void appendNumber(std::string &buffer, double value);
+void appendNumber(std::string &buffer, std::size_t value);
+
+void serializeInitRecord(std::string &buffer,
+                         InitSimulationParams const &parameters,
+                         std::size_t timeStepDivisor = 1);
+void serializeHeader(std::string &buffer, std::string const &filename,
+                     double pericentre, double planetDistance,
+                     std::size_t timeStepDivisor = 1);
+void serializeBody(std::string &buffer, Body const &body);
+
+inline void serializeBodies(std::string &buffer) { (void)(buffer); }
+
+template <typename... Bodies>
+void serializeBodies(std::string &buffer, Body const &body,
+                     Bodies const &... bodies) {
+  serializeBody(buffer, body);
+  serializeBodies(buffer, bodies...);
+}
+
+} // namespace InitFileSerializer
+
+#endif /* INIT_FILE_SERIALIZER_H */
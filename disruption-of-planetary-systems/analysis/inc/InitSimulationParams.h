@@ -1,12 +1,16 @@
 #ifndef INITSIMULATIONPARAMS_H
 #define INITSIMULATIONPARAMS_H
 
+#include <array>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+class RandomStream;
+
 /*
 The parameters found in the headers of .init files
 */
@@ -43,35 +47,77 @@ private:
 };
 
 /*
-The simulation parameters used to calculate body positions and velocities
+The simulation parameters used to calculate body positions and velocities. The
+record is trivially copyable, and the filename is derived from it on demand
 */
 struct InitSimulationParams {
-  InitSimulationParams(std::string const &filename, double pericentre,
+  InitSimulationParams(std::uint64_t runId, double pericentre,
                        double planetDistance, std::size_t orientationIndex,
                        std::size_t phi, std::size_t inclination);
-  InitSimulationParams(std::string const &filename, double pericentre,
+  InitSimulationParams(std::uint64_t runId, double pericentre,
                        double planetDistanceA, double planetDistanceB,
                        std::size_t orientationIndex, std::size_t phi,
                        std::size_t inclination);
-  ~InitSimulationParams();
 
   bool operator!=(InitSimulationParams const &otherParams) const;
 
-  std::string m_filename;
+  std::string filename() const;
+  double largestPlanetDistance() const;
+  RandomStream randomStream() const;
+
+  std::uint64_t m_runId;
   double m_pericentre;
-  std::vector<double> m_planetDistances;
-  std::size_t m_orientationIndex;
-  std::size_t m_phi;
-  std::size_t m_inclination;
+  std::array<double, 2> m_planetDistances;
+  std::uint32_t m_orientationIndex;
+  std::uint16_t m_phi;
+  std::uint16_t m_inclination;
+  std::uint8_t m_numberOfPlanets;
 };
 
+/*
+The integrator used to simulate each run. Comparison runs NewARC.out and the
+built-in integrator on the same initial conditions and reports the differences.
+Mock writes synthetic .out files and Replay serves recorded ones, so that the
+rest of a sweep can be run without an integrator.
+*/
+enum class IntegratorBackend { External, InProcess, Comparison, Mock, Replay };
+
+/*
+The format of the results files. CSV and binary files are easier to load into
+other tools than the space separated text of earlier sweeps.
+*/
+enum class ResultsFormat { Text, CSV, Binary };
+
 /*
 Other settings used for the simulation
 */
 struct OtherSimulationSettings {
+  static std::size_t numberOfIntegrators();
+  static std::size_t earlyTerminationWindow();
+
+  static std::uint64_t m_sweepSeed;
   static bool m_hasSinglePlanet;
   static bool m_combinePlanetResults;
   static bool m_useDefaults;
+  static bool m_usePackedFiles;
+  static std::size_t m_numberOfIntegrators;
+  static bool m_deleteOutFiles;
+  static bool m_resumeSweep;
+  static IntegratorBackend m_integratorBackend;
+  static std::size_t m_earlyTerminationWindow;
+  static std::size_t m_wallTimeLimit;
+  static std::size_t m_cpuTimeLimit;
+  static std::size_t m_memoryLimit;
+  static std::size_t m_stallTimeLimit;
+  static std::size_t m_maximumRetries;
+  static std::string m_coordinatorAddress;
+  static std::size_t m_numberOfShards;
+  static std::size_t m_mockTimeSteps;
+  static std::size_t m_mockLatency;
+  static std::string m_replayDirectory;
+  static bool m_writeOrbitalElements;
+  static std::size_t m_bootstrapResamples;
+  static ResultsFormat m_resultsFormat;
 };
 
 #endif /* INITSIMULATIONPARAMS_H */
@@ -0,0 +1,52 @@
+#ifndef INTEGRATORCOMPARISON_H
+#define INTEGRATORCOMPARISON_H
+
+#include "SimulationResult.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct InitSimulationParams;
+
+class Body;
+
+/*
+Compares the trajectories of NewARC.out with those of the built-in integrator.
+For every planet of a run the final separations from the star, and of the star
+from the black hole, are compared along with the classification and orbital
+elements of the planet. The comparisons are saved to integrator_comparison.txt
+in the order of their run IDs. NewARC.out is not stopped early when comparing,
+so that both trajectories end at the same time.
+*/
+class IntegratorComparison {
+public:
+  IntegratorComparison(std::string const &directory);
+  ~IntegratorComparison();
+
+  void reset();
+  void addComparison(InitSimulationParams const &parameters,
+                     std::vector<std::unique_ptr<Body>> const &externalBodies,
+                     std::vector<std::unique_ptr<Body>> const &internalBodies,
+                     std::vector<RunOutcome> const &externalOutcomes,
+                     std::vector<RunOutcome> const &internalOutcomes);
+  void save() const;
+
+private:
+  std::string generateComparisonLine(
+      std::string const &filename, std::size_t planetIndex,
+      double starSeparationError, double planetSeparationError,
+      RunOutcome const &externalOutcome,
+      RunOutcome const &internalOutcome) const;
+
+  std::string m_directory;
+  std::map<std::uint64_t, std::string> m_comparisonLines;
+  std::size_t m_numberOfPlanets;
+  std::size_t m_numberOfAgreements;
+
+  mutable std::mutex m_mutex;
+};
+
+#endif /* INTEGRATORCOMPARISON_H */
@@ -0,0 +1,113 @@
+#ifndef INTEGRATORSCHEDULER_H
+#define INTEGRATORSCHEDULER_H
+
+#ifdef __linux__
+
+#include "InitSimulationParams.h"
+#include "OutcomeMonitor.h"
+#include "SimulationBackend.h"
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+/*
+Runs up to a fixed number of integrator processes at once. Each process is
+started with posix_spawn in its own scratch directory, reads its init record
+from stdin and writes its log to a data.log in the scratch directory. The
+completion handler is called on the submitting thread once a process has been
+reaped, with the path of the .out file it produced and its wall time. Only the
+processes it started are waited for. Waiting stops early, and the running
+processes are terminated, once the keep running check fails. Processes still
+running a few seconds after being asked to exit are killed.
+When an early termination window is set, the .out file of each process is
+followed while it runs, and a process is stopped as soon as the outcome of its
+run is decided. Its partial trajectory is then kept as a successful run, and
+it is killed if it has not exited a few seconds later.
+
+Each process is also held to the limits in OtherSimulationSettings. It is
+killed when it runs past its wall-clock limit, or when its .out file stops
+growing for the stall limit. Its CPU time and address space are capped with
+rlimits, set by the IntegratorLauncher helper which then execs the integrator,
+so that the limits hold from its first instruction. A process which fails
+while integrating, by exiting with an error or stalling, is run again with its
+time step halved, up to the maximum number of retries. A process which runs
+past its wall-clock or CPU time limit fails at once. The completion handler is
+only called for its final attempt, with the reason it failed, or an empty
+reason if it succeeded.
+*/
+class IntegratorScheduler : public SimulationBackend {
+public:
+  IntegratorScheduler(std::string const &directory,
+                      std::size_t numberOfWorkers,
+                      CompletionHandler const &completionHandler,
+                      std::function<bool()> const &keepRunning);
+  ~IntegratorScheduler() override;
+
+  std::size_t numberOfWorkers() const override;
+
+  bool submitFile(InitSimulationParams const &parameters,
+                  std::string const &initFilename) override;
+  bool submitRecord(InitSimulationParams const &parameters,
+                    std::string const &initRecord) override;
+
+  bool poll() override;
+  bool waitForAll() override;
+  void terminateAll();
+
+private:
+  struct Worker {
+    std::string m_scratchDirectory;
+    pid_t m_pid;
+    InitSimulationParams m_parameters;
+    std::chrono::steady_clock::time_point m_startTime;
+    std::unique_ptr<OutcomeMonitor> m_monitor;
+    bool m_terminatedEarly;
+    std::chrono::steady_clock::time_point m_killTime;
+    std::size_t m_attempt;
+    std::string m_failure;
+    bool m_stalled;
+    off_t m_outSize;
+    std::chrono::steady_clock::time_point m_lastGrowth;
+  };
+
+  struct Retry {
+    InitSimulationParams m_parameters;
+    std::size_t m_attempt;
+  };
+
+  Worker *acquireWorker();
+  Worker &idleWorker();
+  void launchRecord(Worker &worker, InitSimulationParams const &parameters,
+                    std::string const &initRecord, std::size_t attempt);
+  void launch(Worker &worker, InitSimulationParams const &parameters,
+              int inputDescriptor, std::size_t attempt);
+  void launchRetries();
+  bool waitForWorker();
+  void monitorWorkers();
+  void enforceLimits(Worker &worker);
+  bool reap();
+  bool waitForExit(Worker &worker, int options, int &status);
+  void discard(Worker &worker);
+  void complete(Worker &worker, int status);
+  std::string failureReason(Worker const &worker, int status) const;
+  bool isIntegrationFailure(Worker const &worker, int status) const;
+
+  std::string m_directory;
+  std::string m_executable;
+  std::string m_launcher;
+  std::vector<Worker> m_workers;
+  std::size_t m_running;
+  std::deque<Retry> m_retries;
+  CompletionHandler m_completionHandler;
+  std::function<bool()> m_keepRunning;
+};
+
+#endif /* __linux__ */
+
+#endif /* INTEGRATORSCHEDULER_H */
@@ -0,0 +1,29 @@
+#ifndef MOCKOUTFILESOURCE_H
+#define MOCKOUTFILESOURCE_H
+
+#include "SyntheticBackend.h"
+
+#include <cstddef>
+#include <string>
+
+/*
+Writes synthetic .out files in the format of NewARC.out, holding every body of
+the run moving in a straight line from its initial conditions. The number of
+rows and a latency added to every run are set in OtherSimulationSettings, so
+that the cost of the rest of a sweep can be measured with files of a realistic
+size and without the hours taken by the integrator.
+*/
+class MockOutFileSource : public OutFileSource {
+public:
+  MockOutFileSource();
+  ~MockOutFileSource() override;
+
+  void writeOutFile(InitSimulationParams const &parameters,
+                    std::string const &outFilename) const override;
+
+private:
+  std::size_t m_numberOfTimeSteps;
+  std::size_t m_latency;
+};
+
+#endif /* MOCKOUTFILESOURCE_H */
@@ -0,0 +1,29 @@
+#ifndef NBODYINTEGRATOR_H
+#define NBODYINTEGRATOR_H
+
+#include <memory>
+#include <vector>
+
+class Body;
+
+/*
+An adaptive Dormand-Prince 5(4) integrator used in place of NewARC.out when the
+built-in integrator is selected. The step size is controlled by a relative
+tolerance on the positions and velocities, and is shortened to land on every
+output time so that the trajectory is sampled at the same times as the rows of
+an .out file, starting with the initial state.
+*/
+class NBodyIntegrator {
+public:
+  NBodyIntegrator(double tolerance = 1e-11);
+  ~NBodyIntegrator();
+
+  std::vector<std::unique_ptr<Body>>
+  integrate(std::vector<std::unique_ptr<Body const>> const &bodies,
+            double timeStep, std::size_t numberOfTimeSteps) const;
+
+private:
+  double m_tolerance;
+};
+
+#endif /* NBODYINTEGRATOR_H */
@@ -0,0 +1,32 @@
+#ifndef OUT_FILE_PARSER_H
+#define OUT_FILE_PARSER_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+class Body;
+
+/*
+Reads the trajectories of the bodies from the text of an .out file held in
+memory. Each row holds the time followed by the mass, position and velocity of
+the black hole, the star and then the planets. The time and mass columns are
+skipped without being converted, since the masses of the bodies are fixed, and
+the remaining columns are converted with std::from_chars. Reading stops at the
+first row which is incomplete. The rows can either be collected into bodies or
+handed on one at a time as the state of every body, its position followed by
+its velocity, without keeping the trajectory.
+*/
+namespace OutFileParser {
+
+using StateHandler = std::function<void(double const *state)>;
+
+std::vector<std::unique_ptr<Body>> parseBodies(char const *begin,
+                                               char const *end,
+                                               std::size_t numberOfBodies);
+void parseStates(char const *begin, char const *end,
+                 std::size_t numberOfBodies, StateHandler const &handler);
+
+} // namespace OutFileParser
+
+#endif /* OUT_FILE_PARSER_H */
@@ -0,0 +1,42 @@
+#ifndef OUTCOMEMONITOR_H
+#define OUTCOMEMONITOR_H
+
+#include "BoundEnergyTracker.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+Follows the .out file of a running integrator and classifies each planet with
+the energy criteria of the analysis as the rows are written. The outcome of
+the run is decided once the classification of every planet has been the same
+for a given number of consecutive rows, after which the integrator can be
+stopped and the .out file cut back to its complete rows.
+*/
+class OutcomeMonitor {
+public:
+  OutcomeMonitor(std::string const &outFilename, std::size_t numberOfBodies,
+                 std::size_t stableWindow);
+  ~OutcomeMonitor();
+
+  bool isDecided();
+  void truncateToCompleteRows() const;
+
+private:
+  void readRows();
+  void addState(double const *state);
+  std::vector<int> classifications() const;
+
+  std::string m_outFilename;
+  std::size_t m_numberOfBodies;
+  std::size_t m_stableWindow;
+
+  std::uint64_t m_completeLength;
+  std::vector<BoundEnergyTracker> m_starTrackers;
+  std::vector<BoundEnergyTracker> m_blackHoleTrackers;
+  std::vector<int> m_classifications;
+  std::size_t m_stableRows;
+};
+
+#endif /* OUTCOMEMONITOR_H */
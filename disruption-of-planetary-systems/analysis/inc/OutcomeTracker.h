@@ -0,0 +1,40 @@
+#ifndef OUTCOMETRACKER_H
+#define OUTCOMETRACKER_H
+
+#include "BoundEnergyTracker.h"
+#include "SimulationResult.h"
+
+#include <memory>
+#include <vector>
+
+class Body;
+
+/*
+Classifies each planet of a run and computes its orbital elements one time step
+of the trajectory at a time, so that a run can be analysed in constant memory
+as its .out file is read. A state holds the position and then the velocity of
+the black hole, the star and the planets. Every time step but the last is
+checked by the energy criteria, and the orbital elements are those of the last.
+Whole trajectories held in memory are swept once, a block of time steps at a
+time, for the energies of every planet.
+*/
+class OutcomeTracker {
+public:
+  OutcomeTracker(std::size_t numberOfBodies);
+  ~OutcomeTracker();
+
+  void addState(double const *state);
+  void addTrajectories(std::vector<std::unique_ptr<Body>> const &bodies);
+  std::vector<RunOutcome> outcomes() const;
+
+private:
+  void addEnergies();
+
+  std::size_t m_numberOfBodies;
+  std::vector<double> m_lastState;
+  bool m_hasState;
+  std::vector<BoundEnergyTracker> m_starTrackers;
+  std::vector<BoundEnergyTracker> m_blackHoleTrackers;
+};
+
+#endif /* OUTCOMETRACKER_H */
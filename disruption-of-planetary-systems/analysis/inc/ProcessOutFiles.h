@@ -1,7 +1,11 @@
 #ifndef PROCESSOUTFILES_H
 #define PROCESSOUTFILES_H
 
-#include <fstream>
+#include "FractionIntervals.h"
+#include "ResultGrid.h"
+
+#include <array>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -10,111 +14,105 @@
 #include <vector>
 
 struct InitSimulationParams;
-struct MultiPlanetResult;
-struct SimulationResult;
+struct RunOutcome;
+struct SweepDefinition;
 
 class Body;
 class MutableResult;
+class PackedFileReader;
+class ResultsWriter;
+class SimulationParamsStream;
+class SweepJournal;
 class TaskRunner;
 
+/*
+Analyses the .out files of a sweep and aggregates the outcomes of each planet
+by pericentre and planet distance. Every thread recording outcomes adds them to
+its own result grids without locking, and the grids are merged when the results
+are saved.
+*/
 class OutFileProcessor {
-
-  enum PlanetID { None, A, B } const;
-
 public:
-  OutFileProcessor(std::string const &directory);
+  OutFileProcessor(std::string const &directory, SweepJournal &journal);
   ~OutFileProcessor();
 
-  bool performAnalysis(
-      std::vector<InitSimulationParams> const &simulationParameters);
+  bool performAnalysis(SweepDefinition const &sweep);
 
-private:
-  void resetProcessor(std::size_t numberOfOutFiles);
-
-  void processOutFiles(
-      std::vector<InitSimulationParams> const &simulationParameters);
+  void resetResults(SweepDefinition const &sweep);
   void processOutFile(InitSimulationParams const &parameters);
-  void processOutFile(InitSimulationParams const &parameters,
-                      std::vector<std::unique_ptr<Body>> const &bodies);
-
-  void computeSimulationResults4Body(InitSimulationParams const &parameters,
-                                     Body const &blackHole, Body const &star,
-                                     Body const &planetA, Body const &planetB);
-  void computeSimulationResults(InitSimulationParams const &parameters,
-                                Body const &blackHole, Body const &star,
-                                Body const &planet, double planetDistance,
-                                PlanetID const &planetID = PlanetID::None);
+  void processOutRecord(InitSimulationParams const &parameters,
+                        std::string const &outRecord);
+  std::vector<RunOutcome>
+  processTrajectory(InitSimulationParams const &parameters,
+                    std::vector<std::unique_ptr<Body>> const &bodies);
+  void recordOutcomes(InitSimulationParams const &parameters,
+                      std::vector<RunOutcome> const &outcomes);
+  bool restoreOutcomes(InitSimulationParams const &parameters);
 
   std::vector<std::unique_ptr<Body>>
   loadOutFile(InitSimulationParams const &parameters) const;
-  std::vector<std::unique_ptr<Body>>
-  loadOutFile(std::ifstream &fileStream) const;
-  std::vector<std::unique_ptr<Body>>
-  loadOutFile3Body(std::ifstream &fileStream) const;
-  std::vector<std::unique_ptr<Body>>
-  loadOutFile4Body(std::ifstream &fileStream) const;
-
-  std::vector<double>
-  calculateBodyTotalEnergies(Body const &targetBody, Body const &otherBody,
-                             std::size_t numberOfTimeSteps) const;
-  double calculateTotalEnergy(Body const &targetBody, Body const &otherBody,
-                              std::size_t index) const;
-
-  bool isBound(Body const &targetBody, Body const &otherBody,
-               std::size_t index) const;
-  bool isBound(std::vector<double> const &energies) const;
-
-  double calculateHillsRadius(double pericentre) const;
-
-  std::pair<double, double> calculateOrbitalProperties(Body const &body1,
-                                                       Body const &body2,
-                                                       std::size_t index,
-                                                       bool bound) const;
-  double calculateSemiMajorAxis(Body const &body1, Body const &body2,
-                                std::size_t index) const;
-  double calculateEccentricity(Body const &body1, Body const &body2,
-                               double semiMajorAxis, std::size_t index) const;
-
-  void addResult(double pericentre, double planetDistance, bool bhBound,
-                 bool starBound, double semiMajorBh, double semiMajorStar,
-                 double eccentricityBh, double eccentricityStar,
-                 PlanetID const &planetID);
-  void addResult(std::map<std::pair<double, double>, MutableResult> &results,
-                 double pericentre, double planetDistance, bool bhBound,
-                 bool starBound, double semiMajorBh, double semiMajorStar,
-                 double eccentricityBh, double eccentricityStar);
-  bool updateResult(std::map<std::pair<double, double>, MutableResult> &results,
-                    double pericentre, double planetDistance, bool bhBound,
-                    bool starBound, double semiMajorBh, double semiMajorStar,
-                    double eccentricityBh, double eccentricityStar);
-  template <typename Predicate>
-  bool updateResult(std::map<std::pair<double, double>, MutableResult> &results,
-                    double pericentre, double planetDistance, bool bhBound,
-                    bool starBound, double semiMajorBh, double semiMajorStar,
-                    double eccentricityBh, double eccentricityStar,
-                    Predicate const &predicate);
-
+  std::vector<RunOutcome>
+  streamOutcomes(InitSimulationParams const &parameters) const;
+  std::vector<RunOutcome>
+  computeOutcomes(std::vector<std::unique_ptr<Body>> const &bodies) const;
   void saveResults() const;
-  void saveResults(std::string const &filename,
-                   std::string const &fileText) const;
-  void save3BodyResults() const;
-  void save4BodyResults() const;
 
-  std::map<std::pair<double, double>, MutableResult> combineResults() const;
+private:
+  void resetProcessor(SweepDefinition const &sweep,
+                      std::size_t numberOfOutFiles);
 
-  std::string generateResultsFileText(
+  void processOutFiles(SimulationParamsStream &parametersStream);
+  void processOutFiles(std::vector<InitSimulationParams> const &parameters);
+  void deleteOutFiles();
+  void deleteOutFile(InitSimulationParams const &parameters) const;
+
+  void addOutcomes(InitSimulationParams const &parameters,
+                   std::vector<RunOutcome> const &outcomes);
+
+  template <typename Parser>
+  auto parseOutFile(InitSimulationParams const &parameters,
+                    Parser const &parser) const;
+
+  std::vector<ResultGrid> &threadResults();
+  std::vector<ResultGrid> mergeResults() const;
+
+  void saveResults(
+      std::string const &suffix,
+      std::map<std::pair<double, double>, MutableResult> const &results) const;
+  void save3BodyResults(std::vector<ResultGrid> const &results) const;
+  void save4BodyResults(std::vector<ResultGrid> const &results) const;
+
+  std::map<std::pair<double, double>, MutableResult>
+  combineResults(std::vector<ResultGrid> const &results) const;
+
+  std::vector<std::string> resultsColumns() const;
+  std::vector<std::string> resultsListColumns() const;
+  void writeResults(
+      std::string const &filename,
+      std::map<std::pair<double, double>, MutableResult> const &results) const;
+  void writeResultRow(
+      ResultsWriter &writer, std::pair<double, double> const &parameters,
+      MutableResult const &result,
+      std::array<FractionInterval, 3> const &bootstrapIntervals) const;
+  std::vector<std::array<FractionInterval, 3>> bootstrapIntervals(
+      std::map<std::pair<double, double>, MutableResult> const &results) const;
+  void writeHistograms(
+      std::string const &filename,
       std::map<std::pair<double, double>, MutableResult> const &results) const;
-  std::string
-  generateResultFileLine(std::pair<double, double> const &parameters,
-                         MutableResult const &result) const;
 
-  std::mutex m_mutex;
+  mutable std::mutex m_mutex;
 
   std::string m_directory;
+  SweepJournal &m_journal;
   TaskRunner &m_taskRunner;
 
-  std::map<std::pair<double, double>, MutableResult> m_resultsA;
-  std::map<std::pair<double, double>, MutableResult> m_resultsB;
+  std::unique_ptr<PackedFileReader> m_outPack;
+
+  // The empty grid of each planet copied for every thread, and the grids of
+  // the threads recording outcomes since the results were reset
+  std::vector<ResultGrid> m_emptyResults;
+  std::vector<std::unique_ptr<std::vector<ResultGrid>>> m_threadResults;
+  std::uint64_t m_resultsGeneration;
 };
 
 #endif /* PROCESSOUTFILES_H */
@@ -0,0 +1,39 @@
+#ifndef QUANTILESKETCH_H
+#define QUANTILESKETCH_H
+
+#include <cstdint>
+#include <map>
+
+/*
+A mergeable sketch of the quantiles of a series of values, each estimated to
+within a relative error of RELATIVE_ACCURACY. Positive values are counted in
+logarithmically spaced buckets and the rest in a bucket of zeros. Buckets more
+than MAXIMUM_BUCKETS below the highest are folded into the lowest bucket kept.
+The counts do not depend on the order the values are added or sketches are
+merged.
+*/
+class QuantileSketch {
+public:
+  static double constexpr RELATIVE_ACCURACY = 0.005;
+  static std::size_t constexpr MAXIMUM_BUCKETS = 2048;
+
+  QuantileSketch();
+  ~QuantileSketch();
+
+  void add(double value);
+  void merge(QuantileSketch const &otherSketch);
+
+  std::uint64_t count() const;
+  double quantile(double fraction) const;
+
+private:
+  int bucketIndex(double value) const;
+  double bucketValue(int index) const;
+  void foldLowestBuckets();
+
+  std::map<int, std::uint64_t> m_buckets;
+  std::uint64_t m_zeroCount;
+  std::uint64_t m_count;
+};
+
+#endif /* QUANTILESKETCH_H */
@@ -0,0 +1,38 @@
+#ifndef RANDOMSTREAM_H
+#define RANDOMSTREAM_H
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+The draws taken from the random stream of a simulation. Each draw has a fixed
+counter so that the values do not depend on the order they are requested in
+*/
+enum RandomDraw : std::uint64_t { Phi, Inclination, TrueAnomaly };
+
+/*
+A counter-based random number stream keyed by the sweep seed and the
+parameters of a single simulation. The n-th value of a stream is a pure
+function of its key and n, so simulations can be generated on any thread
+*/
+class RandomStream {
+public:
+  RandomStream(std::uint64_t sweepSeed, double pericentre,
+               double planetDistance, std::size_t orientationIndex);
+  RandomStream(std::uint64_t sweepSeed, double pericentre,
+               double planetDistanceA, double planetDistanceB,
+               std::size_t orientationIndex);
+  ~RandomStream();
+
+  std::uint64_t value(std::uint64_t counter) const;
+
+  std::size_t uniformInteger(std::uint64_t counter, std::size_t lower,
+                             std::size_t higher) const;
+  double uniformDouble(std::uint64_t counter, double lower,
+                       double higher) const;
+
+private:
+  std::uint64_t m_key;
+};
+
+#endif /* RANDOMSTREAM_H */
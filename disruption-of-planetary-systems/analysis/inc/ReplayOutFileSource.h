@@ -0,0 +1,28 @@
+#ifndef REPLAYOUTFILESOURCE_H
+#define REPLAYOUTFILESOURCE_H
+
+#include "SyntheticBackend.h"
+
+#include <memory>
+#include <string>
+
+class PackedFileReader;
+
+/*
+Serves the .out files recorded by an earlier sweep, either as individual files
+or from the packed .out file of its directory. A run with no recording fails.
+*/
+class ReplayOutFileSource : public OutFileSource {
+public:
+  ReplayOutFileSource(std::string const &directory);
+  ~ReplayOutFileSource() override;
+
+  void writeOutFile(InitSimulationParams const &parameters,
+                    std::string const &outFilename) const override;
+
+private:
+  std::string m_directory;
+  std::unique_ptr<PackedFileReader> m_outPack;
+};
+
+#endif /* REPLAYOUTFILESOURCE_H */
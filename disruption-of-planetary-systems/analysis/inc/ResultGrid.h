@@ -0,0 +1,37 @@
+#ifndef RESULTGRID_H
+#define RESULTGRID_H
+
+#include "SimulationResult.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+/*
+The results of one planet over a dense grid of pericentre and planet distance
+cells. Outcomes are added to their cell in place, and the grids filled by
+separate threads are merged once the analysis is done. Only the cells with
+outcomes are results, and their orbital elements are in run ID order so that
+the results do not depend on the number of threads or the order runs finish.
+*/
+class ResultGrid {
+public:
+  ResultGrid(std::vector<double> const &pericentres,
+             std::vector<double> const &planetDistances);
+  ~ResultGrid();
+
+  void addOutcome(double pericentre, double planetDistance, std::uint64_t runId,
+                  RunOutcome const &outcome);
+  void merge(ResultGrid const &otherGrid);
+
+  std::map<std::pair<double, double>, MutableResult> results() const;
+
+private:
+  std::size_t cellIndex(double pericentre, double planetDistance) const;
+
+  std::vector<double> m_pericentres;
+  std::vector<double> m_planetDistances;
+  std::vector<MutableResult> m_cells;
+};
+
+#endif /* RESULTGRID_H */
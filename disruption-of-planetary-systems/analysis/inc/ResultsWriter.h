@@ -0,0 +1,61 @@
+#ifndef RESULTSWRITER_H
+#define RESULTSWRITER_H
+
+#include "InitSimulationParams.h"
+
+#include "BufferedFileWriter.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+Streams the rows of a results file straight into a buffered file as they are
+formatted. Every row holds a value for each column followed by a list of values
+for each list column.
+
+Text files keep the space separated layout of earlier sweeps. CSV files have a
+header line and hold each list in a single field, its values separated by
+semicolons. Binary files start with the magic "DPSRES01", the number of
+columns and the size of the column names as 64-bit integers, and the names
+themselves, each terminated by a null character and padded to a multiple of
+eight bytes. Each row follows as a fixed-width record of one double per column
+in the byte order of the machine, so that the file can be loaded without
+parsing. List columns are left out of binary files.
+*/
+class ResultsWriter {
+public:
+  ResultsWriter(std::string const &filename, ResultsFormat format,
+                std::vector<std::string> const &columns,
+                std::vector<std::string> const &listColumns);
+  ~ResultsWriter();
+
+  static std::string extension(ResultsFormat format);
+
+  // Formats numbers straight into a file as std::to_string would
+  static void appendFixed(BufferedFileWriter &file, double value);
+  static void appendInteger(BufferedFileWriter &file, std::uint64_t value);
+
+  void addValue(double value);
+  void addList(std::vector<double> const &values);
+  void endRow();
+
+  void finish();
+
+private:
+  void writeHeader(std::vector<std::string> const &columns,
+                   std::vector<std::string> const &listColumns);
+  void appendNumber(double value);
+
+  std::string m_filename;
+  ResultsFormat m_format;
+  std::size_t m_numberOfColumns;
+  std::size_t m_numberOfListColumns;
+  BufferedFileWriter m_file;
+
+  // The values and lists added to the current row
+  std::size_t m_numberOfValues;
+  std::size_t m_numberOfLists;
+};
+
+#endif /* RESULTSWRITER_H */
@@ -0,0 +1,46 @@
+#ifndef RUNCOSTMODEL_H
+#define RUNCOSTMODEL_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+struct InitSimulationParams;
+
+/*
+Predicts the wall time of a run from the wall times of earlier runs with the
+same pericentre and planet distances, which are kept in run_costs.txt in the
+sweep directory. Runs without any timings are predicted from their number of
+time steps, scaled by the average time per step observed so far.
+*/
+class RunCostModel {
+  using Cell = std::tuple<double, double, double>;
+
+  struct CellTiming {
+    double m_totalSeconds;
+    std::size_t m_numberOfRuns;
+  };
+
+public:
+  RunCostModel(std::string const &directory);
+  ~RunCostModel();
+
+  void load();
+  void save() const;
+
+  double predictedCost(double pericentre, double planetDistanceA,
+                       double planetDistanceB) const;
+  void recordRun(InitSimulationParams const &parameters, double seconds);
+
+private:
+  double numberOfTimeSteps(Cell const &cell) const;
+  double secondsPerTimeStep() const;
+
+  std::string m_filename;
+  std::map<Cell, CellTiming> m_timings;
+
+  mutable std::mutex m_mutex;
+};
+
+#endif /* RUNCOSTMODEL_H */
@@ -6,29 +6,29 @@
 #include <vector>
 
 struct InitSimulationParams;
+struct SweepDefinition;
 
 class FileManager;
+class PackedFileReader;
+class PackedFileWriter;
+class SimulationParamsStream;
+class SweepJournal;
 class TaskRunner;
 
 class InitFileSimulator {
 
 public:
-  InitFileSimulator(std::string const &drive, std::string const &subDirectory);
+  InitFileSimulator(std::string const &drive, std::string const &subDirectory,
+                    SweepJournal &journal);
   ~InitFileSimulator();
 
-  bool simulateInitFiles(
-      std::vector<InitSimulationParams> const &simulationParameters);
+  bool simulateInitFiles(SweepDefinition const &sweep);
 
 private:
-  void resetSimulator(std::size_t numberOfIntermissions);
+  void resetSimulator(std::size_t numberOfSteps);
+
+  bool runInitFileBatches(SimulationParamsStream &parametersStream);
 
-  bool simulateInitFiles(
-      std::vector<InitSimulationParams> const &simulationParameters,
-      std::size_t numberOfIntermissions, std::size_t remainder);
-  void simulateInitFiles(
-      std::vector<InitSimulationParams>::const_iterator const &beginIter,
-      std::size_t numberOfIntermissions, std::size_t remainder,
-      std::size_t index) const;
   void simulateInitFiles(
       std::vector<InitSimulationParams>::const_iterator const &startIter,
       std::vector<InitSimulationParams>::const_iterator const &endIter) const;
@@ -36,17 +36,26 @@ private:
   std::string getCommand(
       std::vector<InitSimulationParams>::const_iterator const &startIter,
       std::vector<InitSimulationParams>::const_iterator const &endIter) const;
+  std::string getCommand(InitSimulationParams const &parameters) const;
+
+  void openPackedFiles();
+  void closePackedFiles();
+  void packOutFiles(
+      std::vector<InitSimulationParams>::const_iterator const &startIter,
+      std::vector<InitSimulationParams>::const_iterator const &endIter) const;
 
-  void deleteInitFiles(
-      std::vector<InitSimulationParams> const &simulationParameters) const;
+  void deleteInitFiles(SweepDefinition const &sweep) const;
   void deleteFile(std::string const &filename) const;
 
   std::size_t m_step = 10;
 
   std::unique_ptr<FileManager> m_fileManager;
+  std::unique_ptr<PackedFileReader> m_initPack;
+  std::unique_ptr<PackedFileWriter> m_outPack;
   std::string m_drive;
   std::string m_subDirectory;
   std::string m_directory;
+  SweepJournal &m_journal;
   TaskRunner &m_taskRunner;
 };
 
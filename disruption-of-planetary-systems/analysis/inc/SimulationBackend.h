@@ -0,0 +1,43 @@
+#ifndef SIMULATIONBACKEND_H
+#define SIMULATIONBACKEND_H
+
+#include <functional>
+#include <memory>
+#include <string>
+
+struct InitSimulationParams;
+
+/*
+Turns the init records of runs into .out files, working on up to a fixed number
+of runs at once. Submitting blocks while every worker is busy. The completion
+handler is called on the submitting thread for every finished run, with the
+path of the .out file, the reason the run failed or an empty reason, and the
+wall time of the run. NewARC.out is run by the IntegratorScheduler, while the
+mock and replay backends write .out files without an integrator so that the
+rest of a sweep can be run and benchmarked on its own.
+*/
+class SimulationBackend {
+public:
+  using CompletionHandler = std::function<void(
+      InitSimulationParams const &parameters, std::string const &outFilename,
+      std::string const &failure, double seconds)>;
+
+  virtual ~SimulationBackend();
+
+  virtual std::size_t numberOfWorkers() const = 0;
+
+  virtual bool submitFile(InitSimulationParams const &parameters,
+                          std::string const &initFilename) = 0;
+  virtual bool submitRecord(InitSimulationParams const &parameters,
+                            std::string const &initRecord) = 0;
+
+  virtual bool poll() = 0;
+  virtual bool waitForAll() = 0;
+};
+
+std::unique_ptr<SimulationBackend> createSimulationBackend(
+    std::string const &directory, std::size_t numberOfWorkers,
+    SimulationBackend::CompletionHandler const &completionHandler,
+    std::function<bool()> const &keepRunning);
+
+#endif /* SIMULATIONBACKEND_H */
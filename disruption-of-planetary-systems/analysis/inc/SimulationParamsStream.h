@@ -0,0 +1,71 @@
+#ifndef SIMULATIONPARAMSSTREAM_H
+#define SIMULATIONPARAMSSTREAM_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct InitSimulationParams;
+
+class RunCostModel;
+
+/*
+The pericentres, planet distances and number of orientations making up a sweep.
+The cells of pericentre and planet distance are visited in sweep order unless
+they have been ordered by their predicted cost. A shard of a sweep visits only
+the cells selected for it, keeping the run IDs of the whole sweep.
+*/
+struct SweepDefinition {
+  SweepDefinition(std::vector<std::string> const &pericentres,
+                  std::vector<std::string> const &planetDistancesA,
+                  std::vector<std::string> const &planetDistancesB,
+                  std::size_t numberOfOrientations);
+  ~SweepDefinition();
+
+  std::size_t numberOfSimulations() const;
+  std::size_t numberOfCells() const;
+
+  void selectCells(std::vector<std::size_t> const &cells);
+  void orderCellsByCost(RunCostModel const &costModel);
+  SweepDefinition inRunOrder() const;
+  double predictedCellCost(RunCostModel const &costModel,
+                           std::size_t cell) const;
+
+  std::vector<std::string> m_pericentres;
+  std::vector<std::string> m_planetDistancesA;
+  std::vector<std::string> m_planetDistancesB;
+  std::size_t m_numberOfOrientations;
+
+  std::vector<double> m_pericentreValues;
+  std::vector<double> m_planetDistanceAValues;
+  std::vector<double> m_planetDistanceBValues;
+
+  std::vector<std::size_t> m_cellOrder;
+};
+
+/*
+Lazily produces the simulation parameters of a sweep in chunks, in the order of
+the cells of pericentre and planet distance and then orientation. Chunks can be
+pulled from several threads.
+*/
+class SimulationParamsStream {
+public:
+  SimulationParamsStream(SweepDefinition const &sweep);
+  ~SimulationParamsStream();
+
+  std::size_t size() const;
+
+  bool next(std::vector<InitSimulationParams> &chunk,
+            std::size_t maximumChunkSize);
+
+private:
+  InitSimulationParams createParameters(std::size_t position) const;
+
+  SweepDefinition const &m_sweep;
+  std::size_t m_size;
+  std::size_t m_position;
+
+  std::mutex m_mutex;
+};
+
+#endif /* SIMULATIONPARAMSSTREAM_H */
@@ -1,9 +1,25 @@
 #ifndef SIMULATION_RESULTS_H
 #define SIMULATION_RESULTS_H
 
+#include "ElementDistribution.h"
+#include "FractionIntervals.h"
+
+#include <cstdint>
 #include <string>
 #include <vector>
 
+/*
+The classification and orbital elements of a single planet at the end of a run
+*/
+struct RunOutcome {
+  bool m_bhBound;
+  bool m_starBound;
+  double m_semiMajorBh;
+  double m_semiMajorStar;
+  double m_eccentricityBh;
+  double m_eccentricityStar;
+};
+
 struct SimulationResult {
   SimulationResult();
   SimulationResult(double hillsRadius, bool bhBound, bool starBound,
@@ -25,14 +41,28 @@ struct SimulationResult {
   std::vector<double> m_semiMajorsStar;
   std::vector<double> m_eccentricitiesBh;
   std::vector<double> m_eccentricitiesStar;
+  std::vector<std::uint64_t> m_runIdsBh;
+  std::vector<std::uint64_t> m_runIdsStar;
+
+  ElementDistribution m_semiMajorBhDistribution =
+      ElementDistribution::semiMajorAxes();
+  ElementDistribution m_semiMajorStarDistribution =
+      ElementDistribution::semiMajorAxes();
+  ElementDistribution m_eccentricityBhDistribution =
+      ElementDistribution::eccentricities();
+  ElementDistribution m_eccentricityStarDistribution =
+      ElementDistribution::eccentricities();
 };
 
+/*
+The outcomes of the runs of a cell. The orbital elements of bound planets are
+summarised by their distributions. The elements themselves are only kept when
+they are to be written, along with the IDs of their runs so that they can be
+put in run ID order whatever order the runs were recorded in.
+*/
 class MutableResult {
 public:
   MutableResult();
-  MutableResult(double hillsRadius, bool bhBound, bool starBound,
-                double semiMajorBh, double semiMajorStar, double eccentricityBh,
-                double eccentricityStar);
   MutableResult(double hillsRadius, std::size_t bhBoundCount,
                 std::size_t starBoundCount, std::size_t totalCount,
                 std::vector<double> semiMajorsBh,
@@ -41,9 +71,12 @@ public:
                 std::vector<double> eccentricitiesStar);
   ~MutableResult();
 
-  MutableResult operator+(MutableResult const &otherResult) const;
+  void addOutcome(std::uint64_t runId, RunOutcome const &outcome);
+  void merge(MutableResult const &otherResult);
+  void orderByRunId();
 
   double hillsRadius() const;
+  std::size_t totalCount() const;
 
   double bhBoundFraction() const;
   double starBoundFraction() const;
@@ -53,15 +86,28 @@ public:
   double starBoundFractionError() const;
   double unboundFractionError() const;
 
+  FractionInterval bhBoundFractionInterval() const;
+  FractionInterval starBoundFractionInterval() const;
+  FractionInterval unboundFractionInterval() const;
+  std::array<FractionInterval, 3>
+  bootstrapFractionIntervals(RandomStream const &randomStream,
+                             std::size_t numberOfResamples) const;
+
   std::vector<double> semiMajorsBh() const;
   std::vector<double> semiMajorsStar() const;
   std::vector<double> eccentricitiesBh() const;
   std::vector<double> eccentricitiesStar() const;
 
+  ElementDistribution const &semiMajorBhDistribution() const;
+  ElementDistribution const &semiMajorStarDistribution() const;
+  ElementDistribution const &eccentricityBhDistribution() const;
+  ElementDistribution const &eccentricityStarDistribution() const;
+
 private:
   void updateCounts(bool bhBound, bool starBound);
-  void updateAverages(double semiMajorBh, double semiMajorStar,
-                      double eccentricityBh, double eccentricityStar);
+  void updateAverages(std::uint64_t runId, double semiMajorBh,
+                      double semiMajorStar, double eccentricityBh,
+                      double eccentricityStar);
 
   mutable SimulationResult m_result;
 };
@@ -0,0 +1,70 @@
+#ifndef SWEEPCOORDINATOR_H
+#define SWEEPCOORDINATOR_H
+
+#ifdef __linux__
+
+#include "InitSimulationParams.h"
+
+#include "LineSocket.h"
+
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+
+struct SweepDefinition;
+
+class OutFileProcessor;
+class SimulationParamsStream;
+class SweepJournal;
+class TaskRunner;
+
+/*
+Hands the runs of a sweep out to workers connected over a socket, and merges
+the outcomes they send back into the results. Each worker is kept supplied with
+as many runs as it can work on at once. The runs held by a worker which
+disconnects are handed to the remaining workers, and runs the journal has
+already settled are restored rather than sent out.
+*/
+class SweepCoordinator {
+  struct Connection {
+    LineSocket m_socket;
+    std::size_t m_capacity;
+    std::map<std::uint64_t, InitSimulationParams> m_assignedRuns;
+  };
+
+public:
+  SweepCoordinator(SweepJournal &journal, OutFileProcessor &outFileProcessor);
+  ~SweepCoordinator();
+
+  bool run(SweepDefinition const &sweep, std::string const &address);
+
+private:
+  void resetCoordinator(SweepDefinition const &sweep,
+                        std::size_t numberOfSimulations);
+
+  bool hasQueuedRun();
+  bool nextRun(InitSimulationParams &parameters);
+  bool isComplete();
+
+  void pollConnections(LineSocket const &listener);
+  void acceptWorker(LineSocket const &listener);
+  bool serviceWorker(Connection &connection);
+  bool handleMessage(Connection &connection, std::string const &message);
+  void assignRuns(Connection &connection);
+  void releaseRuns(Connection &connection);
+
+  SweepJournal &m_journal;
+  OutFileProcessor &m_outFileProcessor;
+  TaskRunner &m_taskRunner;
+
+  std::unique_ptr<SimulationParamsStream> m_parametersStream;
+  std::deque<InitSimulationParams> m_queuedRuns;
+  std::list<Connection> m_connections;
+};
+
+#endif /* __linux__ */
+
+#endif /* SWEEPCOORDINATOR_H */
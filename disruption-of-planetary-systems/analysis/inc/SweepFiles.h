@@ -0,0 +1,12 @@
+#ifndef SWEEP_FILES_H
+#define SWEEP_FILES_H
+
+namespace SweepFiles {
+
+// Packed files used in place of individual .init and .out files
+static char constexpr INIT_PACK[] = "sweep_inits.pack";
+static char constexpr OUT_PACK[] = "sweep_outs.pack";
+
+} // namespace SweepFiles
+
+#endif /* SWEEP_FILES_H */
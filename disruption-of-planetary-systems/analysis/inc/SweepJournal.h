@@ -0,0 +1,63 @@
+#ifndef SWEEPJOURNAL_H
+#define SWEEPJOURNAL_H
+
+#include "SimulationResult.h"
+
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct InitSimulationParams;
+
+enum class RunState { Pending, Generated, Simulated, Analysed, Failed };
+
+/*
+An append-only record of the progress of a sweep, kept in the sweep directory.
+The first line holds the sweep seed and number of bodies, and every following
+line moves a run to a later state. Analysed runs store their outcomes so that
+they can be restored without their .out files. Runs whose integrator failed on
+every attempt are recorded as failed, along with the reason, and are not run
+again. Simulated, analysed and failed runs are flushed to disk before the
+journal returns, and a line left incomplete by a crash is discarded when the
+journal is resumed.
+*/
+class SweepJournal {
+  struct Entry {
+    RunState m_state;
+    std::vector<RunOutcome> m_outcomes;
+  };
+
+public:
+  SweepJournal(std::string const &directory);
+  ~SweepJournal();
+
+  void open(bool resume);
+  void close();
+
+  RunState state(InitSimulationParams const &parameters) const;
+  std::vector<RunOutcome> const &
+  outcomes(InitSimulationParams const &parameters) const;
+
+  void recordGenerated(InitSimulationParams const &parameters);
+  void recordSimulated(InitSimulationParams const &parameters);
+  void recordAnalysed(InitSimulationParams const &parameters,
+                      std::vector<RunOutcome> const &outcomes);
+  void recordFailed(InitSimulationParams const &parameters,
+                    std::string const &reason);
+
+private:
+  bool load();
+  void loadHeader(std::string const &line);
+  void loadEntry(std::string const &line);
+
+  void append(std::string const &line, bool synchronise);
+
+  std::string m_filename;
+  std::FILE *m_file;
+  std::unordered_map<std::string, Entry> m_entries;
+  std::mutex m_mutex;
+};
+
+#endif /* SWEEPJOURNAL_H */
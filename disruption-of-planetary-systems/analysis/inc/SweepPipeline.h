@@ -0,0 +1,87 @@
+#ifndef SWEEPPIPELINE_H
+#define SWEEPPIPELINE_H
+
+#include "InitSimulationParams.h"
+#include "IntegratorComparison.h"
+
+#include "BoundedQueue.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+struct SweepDefinition;
+
+class InitFileGenerator;
+class OutFileProcessor;
+class PackedFileReader;
+class PackedFileWriter;
+class RunCostModel;
+class SweepJournal;
+class TaskRunner;
+
+/*
+Runs the generation, simulation and analysis of a sweep concurrently. Init
+records are passed to an integrator as soon as they are generated, and the
+.out file of a run is analysed as soon as its integrator exits. The stages are
+connected by bounded queues so that the number of init records held in memory
+and of .out files waiting on disk stays proportional to the number of
+integrators. Runs the journal has recorded as simulated or analysed skip the
+stages they have already been through, and the .out files of simulated runs
+are analysed from the out pack when they have already been packed. The
+built-in integrator hands its trajectories to the analysis in memory, so no
+.out files are written, and when comparing integrators each .out file is
+checked against the built-in integrator before it is released. The .out files
+come from the simulation backend of the integrator setting, and NewARC.out can
+only be run on Linux.
+*/
+class SweepPipeline {
+  using InitRecord = std::pair<InitSimulationParams, std::string>;
+
+public:
+  SweepPipeline(std::string const &directory,
+                InitFileGenerator &initFileGenerator,
+                OutFileProcessor &outFileProcessor, SweepJournal &journal,
+                RunCostModel &costModel);
+  ~SweepPipeline();
+
+  bool run(SweepDefinition const &sweep);
+
+private:
+  void resetPipeline(SweepDefinition const &sweep);
+
+  void generateInitRecords(SweepDefinition const &sweep);
+  void queueInitRecord(InitSimulationParams const &parameters,
+                       std::string &&initRecord);
+  bool simulateInitRecords();
+  bool simulateExternally();
+  bool simulateInProcess();
+  void integrateInitRecords();
+  void collectOutFile(InitSimulationParams const &parameters,
+                      std::string const &outFilename,
+                      std::string const &failure, double seconds);
+  void analyseOutFiles();
+  void compareOutFile(InitSimulationParams const &parameters);
+  void releaseOutFile(InitSimulationParams const &parameters);
+
+  void stop(std::string const &errorMessage);
+
+  std::string m_directory;
+  InitFileGenerator &m_initFileGenerator;
+  OutFileProcessor &m_outFileProcessor;
+  SweepJournal &m_journal;
+  RunCostModel &m_costModel;
+  TaskRunner &m_taskRunner;
+
+  std::unique_ptr<BoundedQueue<InitRecord>> m_initRecords;
+  std::unique_ptr<BoundedQueue<InitSimulationParams>> m_outFiles;
+  std::unique_ptr<PackedFileWriter> m_outPack;
+  std::unique_ptr<PackedFileReader> m_resumedOutPack;
+  IntegratorComparison m_comparison;
+
+  std::mutex m_mutex;
+  std::string m_errorMessage;
+};
+
+#endif /* SWEEPPIPELINE_H */
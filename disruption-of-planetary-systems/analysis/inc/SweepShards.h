@@ -0,0 +1,34 @@
+#ifndef SWEEPSHARDS_H
+#define SWEEPSHARDS_H
+
+#include <string>
+#include <vector>
+
+struct SweepDefinition;
+
+class RunCostModel;
+
+/*
+Splits a sweep into shards which can be run as separate jobs with no connection
+between them, and merges their results. A manifest holds the settings and
+definition of the whole sweep along with the cells of pericentre and planet
+distance given to one shard, which are chosen so that the shards have similar
+predicted costs. A shard keeps the run IDs of the whole sweep and saves a
+partial results file holding the raw counts of every cell and the outcomes of
+every run. Merging replays the outcomes of all shards in run ID order, giving
+the same results files as the sweep run on a single machine.
+*/
+namespace SweepShards {
+
+void writeManifests(SweepDefinition const &sweep, RunCostModel const &costModel,
+                    std::size_t numberOfShards, std::string const &directory);
+
+bool runShard(std::string const &manifestFilename,
+              std::string const &directory);
+
+void mergeShards(std::vector<std::string> const &partialResultsFilenames,
+                 std::string const &directory);
+
+} // namespace SweepShards
+
+#endif /* SWEEPSHARDS_H */
@@ -0,0 +1,59 @@
+#ifndef SWEEPWORKER_H
+#define SWEEPWORKER_H
+
+#ifdef __linux__
+
+#include "InitSimulationParams.h"
+#include "ProcessOutFiles.h"
+#include "SweepJournal.h"
+
+#include "BoundedQueue.h"
+#include "LineSocket.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Body;
+
+/*
+Runs simulations for a sweep coordinator on another machine. The worker takes
+its settings from the coordinator, and then integrates the runs it is sent and
+replies with the outcomes of their planets, so only the outcomes cross the
+network. The .out files are written to the working directory of the worker and
+deleted once analysed. A worker comparing integrators runs NewARC.out alone,
+as the comparison is only saved by a local sweep.
+*/
+class SweepWorker {
+public:
+  SweepWorker(std::string const &directory);
+  ~SweepWorker();
+
+  void run(std::string const &address, std::size_t numberOfIntegrators);
+
+private:
+  void receiveRuns();
+  void simulateRuns();
+  void simulateExternally();
+  void simulateInProcess();
+  void integrateRuns();
+  void collectOutFile(InitSimulationParams const &parameters,
+                      std::string const &outFilename,
+                      std::string const &failure);
+  void sendOutcomes(InitSimulationParams const &parameters,
+                    std::vector<std::unique_ptr<Body>> const &bodies);
+  void send(std::string const &message);
+
+  std::string m_directory;
+  SweepJournal m_journal;
+  OutFileProcessor m_outFileProcessor;
+
+  LineSocket m_socket;
+  std::unique_ptr<BoundedQueue<InitSimulationParams>> m_runs;
+  std::mutex m_mutex;
+};
+
+#endif /* __linux__ */
+
+#endif /* SWEEPWORKER_H */
@@ -0,0 +1,80 @@
+#ifndef SYNTHETICBACKEND_H
+#define SYNTHETICBACKEND_H
+
+#include "InitSimulationParams.h"
+#include "SimulationBackend.h"
+
+#include "BoundedQueue.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+Writes the .out file of a run without running an integrator
+*/
+class OutFileSource {
+public:
+  virtual ~OutFileSource();
+
+  virtual void writeOutFile(InitSimulationParams const &parameters,
+                            std::string const &outFilename) const = 0;
+};
+
+/*
+A simulation backend whose workers are threads taking .out files from a
+source. Each worker writes to a scratch directory of its own, and finished
+runs are queued until the submitting thread collects them, so the completion
+handler sees the same threading as with the IntegratorScheduler.
+*/
+class SyntheticBackend : public SimulationBackend {
+  struct Completion {
+    InitSimulationParams m_parameters;
+    std::string m_outFilename;
+    std::string m_failure;
+    double m_seconds;
+  };
+
+public:
+  SyntheticBackend(std::string const &directory, std::size_t numberOfWorkers,
+                   std::unique_ptr<OutFileSource> source,
+                   CompletionHandler const &completionHandler,
+                   std::function<bool()> const &keepRunning);
+  ~SyntheticBackend() override;
+
+  std::size_t numberOfWorkers() const override;
+
+  bool submitFile(InitSimulationParams const &parameters,
+                  std::string const &initFilename) override;
+  bool submitRecord(InitSimulationParams const &parameters,
+                    std::string const &initRecord) override;
+
+  bool poll() override;
+  bool waitForAll() override;
+
+private:
+  bool submit(InitSimulationParams const &parameters);
+  bool waitForCompletions(std::size_t maximumRunning);
+  void collectCompletions();
+  void runWorker(std::string const &scratchDirectory);
+
+  std::string m_directory;
+  std::vector<std::string> m_scratchDirectories;
+  std::unique_ptr<OutFileSource> m_source;
+  CompletionHandler m_completionHandler;
+  std::function<bool()> m_keepRunning;
+
+  BoundedQueue<InitSimulationParams> m_runs;
+  std::vector<std::thread> m_workers;
+  std::size_t m_running;
+
+  std::mutex m_mutex;
+  std::condition_variable m_completed;
+  std::deque<Completion> m_completions;
+};
+
+#endif /* SYNTHETICBACKEND_H */
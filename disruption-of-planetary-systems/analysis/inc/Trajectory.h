@@ -0,0 +1,69 @@
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include "AlignedAllocator.h"
+
+#include <array>
+#include <vector>
+
+struct XYZComponents;
+
+/*
+A read-only view of one component of a trajectory over every time step
+*/
+class ComponentSpan {
+public:
+  ComponentSpan(double const *data, std::size_t size)
+      : m_data(data), m_size(size) {}
+
+  double const *data() const { return m_data; }
+  std::size_t size() const { return m_size; }
+  double operator[](std::size_t index) const { return m_data[index]; }
+
+  double const *begin() const { return m_data; }
+  double const *end() const { return m_data + m_size; }
+
+private:
+  double const *m_data;
+  std::size_t m_size;
+};
+
+/*
+The positions and velocities of a body at every time step, stored as a
+separate contiguous array for each component so that loops over the time steps
+read memory in order. The arrays are aligned to a cache line. Element accessors
+do not check their index.
+*/
+class Trajectory {
+public:
+  static std::size_t constexpr ALIGNMENT = 64;
+
+  Trajectory();
+  ~Trajectory();
+
+  void reserve(std::size_t numberOfTimeSteps);
+  void append(XYZComponents const &position, XYZComponents const &velocity);
+  void append(double const *state);
+
+  std::size_t size() const;
+
+  ComponentSpan x() const;
+  ComponentSpan y() const;
+  ComponentSpan z() const;
+  ComponentSpan vx() const;
+  ComponentSpan vy() const;
+  ComponentSpan vz() const;
+
+  XYZComponents position(std::size_t index) const;
+  XYZComponents velocity(std::size_t index) const;
+
+private:
+  enum Component { X, Y, Z, VX, VY, VZ, NUMBER_OF_COMPONENTS };
+
+  ComponentSpan component(Component component) const;
+
+  using Components = std::vector<double, AlignedAllocator<double, ALIGNMENT>>;
+  std::array<Components, NUMBER_OF_COMPONENTS> m_components;
+};
+
+#endif /* TRAJECTORY_H */
@@ -0,0 +1,58 @@
+#ifndef WORKERPROTOCOL_H
+#define WORKERPROTOCOL_H
+
+#include "SimulationResult.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct InitSimulationParams;
+
+/*
+The messages passed between a sweep coordinator and its workers, one per line.
+The coordinator first sends its settings, and a worker replies with the number
+of runs it can work on at once. The coordinator then sends runs, and the worker
+replies to each with the outcomes of its planets or the reason it failed. The
+coordinator says done once the sweep is complete. Numbers are written in their
+shortest round-trip form so that both sides see the same values. Settings
+which are out of range, such as an unknown integrator backend, are rejected
+with an exception rather than applied.
+*/
+namespace WorkerProtocol {
+
+enum class MessageType {
+  Unknown,
+  Settings,
+  Worker,
+  Run,
+  Outcome,
+  Failed,
+  Done
+};
+
+MessageType messageType(std::string const &message);
+
+std::string settingsMessage();
+bool applySettings(std::string const &message);
+
+std::string workerMessage(std::size_t capacity);
+bool parseWorker(std::string const &message, std::size_t &capacity);
+
+std::string runMessage(InitSimulationParams const &parameters);
+bool parseRun(std::string const &message, InitSimulationParams &parameters);
+
+std::string outcomeMessage(std::uint64_t runId,
+                           std::vector<RunOutcome> const &outcomes);
+bool parseOutcome(std::string const &message, std::uint64_t &runId,
+                  std::vector<RunOutcome> &outcomes);
+
+std::string failedMessage(std::uint64_t runId, std::string const &reason);
+bool parseFailed(std::string const &message, std::uint64_t &runId,
+                 std::string &reason);
+
+std::string doneMessage();
+
+} // namespace WorkerProtocol
+
+#endif /* WORKERPROTOCOL_H */
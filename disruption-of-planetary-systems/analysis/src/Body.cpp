@@ -2,31 +2,29 @@
 
 #include "XYZComponents.h"
 
+#include <utility>
+
 Body::Body(double mass, XYZComponents const &position,
            XYZComponents const &velocity)
     : m_mass(mass) {
-  m_positions.emplace_back(position);
-  m_velocities.emplace_back(velocity);
+  m_trajectory.append(position, velocity);
 }
 
-Body::Body(double mass, std::vector<XYZComponents> const &positions,
-           std::vector<XYZComponents> const &velocities)
-    : m_mass(mass), m_positions(positions), m_velocities(velocities) {}
+Body::Body(double mass, Trajectory &&trajectory)
+    : m_mass(mass), m_trajectory(std::move(trajectory)) {}
 
 Body::~Body() {}
 
 double Body::mass() const { return m_mass; }
 
+Trajectory const &Body::trajectory() const { return m_trajectory; }
+
 XYZComponents Body::position(std::size_t index) const {
-  if (index < m_positions.size())
-    return m_positions[index];
-  throw std::runtime_error("Position index is out of range.");
+  return m_trajectory.position(index);
 }
 
 XYZComponents Body::velocity(std::size_t index) const {
-  if (index < m_velocities.size())
-    return m_velocities[index];
-  throw std::runtime_error("Velocity index is out of range.");
+  return m_trajectory.velocity(index);
 }
 
 double Body::relativePositionMagnitude(Body const &otherBody,
@@ -49,4 +47,4 @@ double Body::relativeVelocityMagnitude(XYZComponents const &otherXYZ,
   return velocity(index).relativeMag(otherXYZ);
 }
 
-std::size_t Body::numberOfTimeSteps() const { return m_positions.size(); }
+std::size_t Body::numberOfTimeSteps() const { return m_trajectory.size(); }
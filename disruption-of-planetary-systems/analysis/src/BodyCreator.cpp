@@ -2,10 +2,12 @@
 
 #include "Body.h"
 #include "InitSimulationParams.h"
+#include "RandomStream.h"
 #include "SimulationConstants.h"
 #include "XYZComponents.h"
 
-#include <cmath>
+#define _USE_MATH_DEFINES
+#include <math.h>
 
 namespace BodyCreator {
 
@@ -58,4 +60,42 @@ std::unique_ptr<Body const> createPlanet(Body const &star,
   return std::make_unique<Body>(PLANET_MASS, std::move(xyz), std::move(vxyz));
 }
 
+double randomizeTrueAnomaly(double pericentre, double planetDistance,
+                            RandomStream const &randomStream) {
+  auto const trueAnomaly =
+      InitHeaderData::trueAnomaly(pericentre, planetDistance);
+
+  auto const x = 2.0 * pericentre * cos(trueAnomaly) / (1 + cos(trueAnomaly));
+  auto const y = 2.0 * pericentre * sin(trueAnomaly) / (1 + cos(trueAnomaly));
+  auto const xyz = XYZComponents(std::move(x), std::move(y), 0.0);
+
+  auto const deltaAnomaly =
+      atan(planetDistance * sin(M_PI - trueAnomaly) /
+           (xyz.magnitude() - planetDistance * cos(M_PI - trueAnomaly)));
+  return randomStream.uniformDouble(RandomDraw::TrueAnomaly,
+                                    trueAnomaly - deltaAnomaly,
+                                    trueAnomaly + deltaAnomaly);
+}
+
+std::vector<std::unique_ptr<Body const>>
+createBodies(InitSimulationParams const &parameters) {
+  auto const pericentre = parameters.m_pericentre;
+  auto const randomStream = parameters.randomStream();
+
+  std::vector<std::unique_ptr<Body const>> bodies;
+  bodies.reserve(2 + parameters.m_numberOfPlanets);
+  bodies.emplace_back(std::make_unique<Body>(*blackHole()));
+  bodies.emplace_back(createStar(
+      pericentre,
+      randomizeTrueAnomaly(pericentre, parameters.largestPlanetDistance(),
+                           randomStream)));
+
+  for (auto i = 0u; i < parameters.m_numberOfPlanets; ++i)
+    bodies.emplace_back(createPlanet(
+        *bodies[1], parameters.m_planetDistances[i],
+        parameters.m_orientationIndex, parameters.m_phi,
+        parameters.m_inclination));
+  return bodies;
+}
+
 } // namespace BodyCreator
@@ -0,0 +1,24 @@
+#include "BoundEnergyTracker.h"
+
+BoundEnergyTracker::BoundEnergyTracker()
+    : m_hasEnergies(false), m_maximumEnergy(0.0), m_minimumAfterMaximum(0.0),
+      m_negativeSinceMinimum(true) {}
+
+BoundEnergyTracker::~BoundEnergyTracker() {}
+
+void BoundEnergyTracker::addEnergy(double energy) {
+  // Ties keep the earliest maximum and minimum
+  if (!m_hasEnergies || energy > m_maximumEnergy) {
+    m_hasEnergies = true;
+    m_maximumEnergy = energy;
+    m_minimumAfterMaximum = energy;
+    m_negativeSinceMinimum = energy < 0.0;
+  } else if (energy < m_minimumAfterMaximum) {
+    m_minimumAfterMaximum = energy;
+    m_negativeSinceMinimum = energy < 0.0;
+  } else {
+    m_negativeSinceMinimum = m_negativeSinceMinimum && energy < 0.0;
+  }
+}
+
+bool BoundEnergyTracker::isBound() const { return m_negativeSinceMinimum; }
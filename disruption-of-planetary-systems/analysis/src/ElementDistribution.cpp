@@ -0,0 +1,44 @@
+#include "ElementDistribution.h"
+
+namespace {
+
+// Semi-major axes are binned four to a decade
+double constexpr SEMI_MAJOR_MINIMUM = 1.0;
+double constexpr SEMI_MAJOR_MAXIMUM = 1e8;
+std::size_t constexpr SEMI_MAJOR_BINS = 32;
+
+std::size_t constexpr ECCENTRICITY_BINS = 20;
+
+} // namespace
+
+ElementDistribution ElementDistribution::semiMajorAxes() {
+  return ElementDistribution(Histogram(SEMI_MAJOR_MINIMUM, SEMI_MAJOR_MAXIMUM,
+                                       SEMI_MAJOR_BINS,
+                                       HistogramScale::Logarithmic));
+}
+
+ElementDistribution ElementDistribution::eccentricities() {
+  return ElementDistribution(
+      Histogram(0.0, 1.0, ECCENTRICITY_BINS, HistogramScale::Linear));
+}
+
+ElementDistribution::ElementDistribution(Histogram const &histogram)
+    : m_quantiles(), m_histogram(histogram) {}
+
+ElementDistribution::~ElementDistribution() {}
+
+void ElementDistribution::add(double value) {
+  m_quantiles.add(value);
+  m_histogram.add(value);
+}
+
+void ElementDistribution::merge(ElementDistribution const &otherDistribution) {
+  m_quantiles.merge(otherDistribution.m_quantiles);
+  m_histogram.merge(otherDistribution.m_histogram);
+}
+
+QuantileSketch const &ElementDistribution::quantiles() const {
+  return m_quantiles;
+}
+
+Histogram const &ElementDistribution::histogram() const { return m_histogram; }
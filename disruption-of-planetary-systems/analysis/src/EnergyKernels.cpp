@@ -0,0 +1,220 @@
+#include "EnergyKernels.h"
+#include "Trajectory.h"
+
+#include <algorithm>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define ENERGY_KERNELS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) && !defined(__clang__)
+// Contracting a multiply and an add into one instruction changes the rounding
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+#if defined(__GNUC__)
+#define KERNEL_TARGET(instructions) __attribute__((target(instructions)))
+#else
+#define KERNEL_TARGET(instructions)
+#endif
+
+using namespace SimulationConstants;
+
+namespace {
+
+using EnergyKernels::InstructionSet;
+
+/*
+The component arrays of two trajectories from the first time step of a range
+*/
+struct TrajectoryPair {
+  TrajectoryPair(Trajectory const &target, Trajectory const &other,
+                 std::size_t first)
+      : x(target.x().data() + first), y(target.y().data() + first),
+        z(target.z().data() + first), vx(target.vx().data() + first),
+        vy(target.vy().data() + first), vz(target.vz().data() + first),
+        ox(other.x().data() + first), oy(other.y().data() + first),
+        oz(other.z().data() + first), ovx(other.vx().data() + first),
+        ovy(other.vy().data() + first), ovz(other.vz().data() + first) {}
+
+  double const *x, *y, *z, *vx, *vy, *vz;
+  double const *ox, *oy, *oz, *ovx, *ovy, *ovz;
+};
+
+void scalarEnergies(TrajectoryPair const &pair, std::size_t begin,
+                    std::size_t end, double targetMass, double otherMass,
+                    double *energies) {
+  for (auto i = begin; i < end; ++i)
+    energies[i] = EnergyKernels::totalEnergy(
+        pair.x[i] - pair.ox[i], pair.y[i] - pair.oy[i],
+        pair.z[i] - pair.oz[i], pair.vx[i] - pair.ovx[i],
+        pair.vy[i] - pair.ovy[i], pair.vz[i] - pair.ovz[i], targetMass,
+        otherMass);
+}
+
+#ifdef ENERGY_KERNELS_X86
+
+// Helpers of a kernel need its target, which lambdas would not inherit
+KERNEL_TARGET("avx2")
+inline __m256d squaredDifference(double const *a, double const *b) {
+  auto const difference = _mm256_sub_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b));
+  return _mm256_mul_pd(difference, difference);
+}
+
+KERNEL_TARGET("avx2")
+void avx2Energies(TrajectoryPair const &pair, std::size_t count,
+                  double targetMass, double otherMass, double *energies) {
+  auto const kinetic = _mm256_set1_pd(0.5 * targetMass);
+  auto const potential = _mm256_set1_pd(G * otherMass * targetMass);
+
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    auto const r = _mm256_sqrt_pd(_mm256_add_pd(
+        _mm256_add_pd(squaredDifference(pair.x + i, pair.ox + i),
+                      squaredDifference(pair.y + i, pair.oy + i)),
+        squaredDifference(pair.z + i, pair.oz + i)));
+    auto const v = _mm256_sqrt_pd(_mm256_add_pd(
+        _mm256_add_pd(squaredDifference(pair.vx + i, pair.ovx + i),
+                      squaredDifference(pair.vy + i, pair.ovy + i)),
+        squaredDifference(pair.vz + i, pair.ovz + i)));
+    _mm256_storeu_pd(
+        energies + i,
+        _mm256_sub_pd(_mm256_mul_pd(kinetic, _mm256_mul_pd(v, v)),
+                      _mm256_div_pd(potential, r)));
+  }
+  scalarEnergies(pair, i, count, targetMass, otherMass, energies);
+}
+
+KERNEL_TARGET("avx512f")
+inline __m512d squaredDifference(__mmask8 mask, double const *a,
+                                 double const *b) {
+  auto const difference = _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, a),
+                                        _mm512_maskz_loadu_pd(mask, b));
+  return _mm512_mul_pd(difference, difference);
+}
+
+KERNEL_TARGET("avx512f")
+void avx512Energies(TrajectoryPair const &pair, std::size_t count,
+                    double targetMass, double otherMass, double *energies) {
+  auto const kinetic = _mm512_set1_pd(0.5 * targetMass);
+  auto const potential = _mm512_set1_pd(G * otherMass * targetMass);
+
+  for (std::size_t i = 0; i < count; i += 8) {
+    // The last time steps are read and written through a partial mask
+    auto const remaining = std::min<std::size_t>(8, count - i);
+    auto const mask = static_cast<__mmask8>((1u << remaining) - 1u);
+
+    auto const r = _mm512_sqrt_pd(_mm512_add_pd(
+        _mm512_add_pd(squaredDifference(mask, pair.x + i, pair.ox + i),
+                      squaredDifference(mask, pair.y + i, pair.oy + i)),
+        squaredDifference(mask, pair.z + i, pair.oz + i)));
+    auto const v = _mm512_sqrt_pd(_mm512_add_pd(
+        _mm512_add_pd(squaredDifference(mask, pair.vx + i, pair.ovx + i),
+                      squaredDifference(mask, pair.vy + i, pair.ovy + i)),
+        squaredDifference(mask, pair.vz + i, pair.ovz + i)));
+    _mm512_mask_storeu_pd(
+        energies + i, mask,
+        _mm512_sub_pd(_mm512_mul_pd(kinetic, _mm512_mul_pd(v, v)),
+                      _mm512_div_pd(potential, r)));
+  }
+}
+
+#ifdef _MSC_VER
+
+InstructionSet detectInstructionSet() {
+  int registers[4];
+  __cpuid(registers, 0);
+  if (registers[0] < 7)
+    return InstructionSet::Scalar;
+
+  __cpuid(registers, 1);
+  auto const osSavesState = (registers[2] & (1 << 27)) != 0;
+  auto const hasAvx = (registers[2] & (1 << 28)) != 0;
+  if (!osSavesState || !hasAvx)
+    return InstructionSet::Scalar;
+
+  // The operating system has to save the vector registers between threads
+  auto const savedState = _xgetbv(0);
+  __cpuidex(registers, 7, 0);
+  if ((registers[1] & (1 << 16)) != 0 && (savedState & 0xe6) == 0xe6)
+    return InstructionSet::AVX512;
+  if ((registers[1] & (1 << 5)) != 0 && (savedState & 0x6) == 0x6)
+    return InstructionSet::AVX2;
+  return InstructionSet::Scalar;
+}
+
+#else
+
+InstructionSet detectInstructionSet() {
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+    return InstructionSet::AVX512;
+  if (__builtin_cpu_supports("avx2"))
+    return InstructionSet::AVX2;
+  return InstructionSet::Scalar;
+}
+
+#endif /* _MSC_VER */
+
+#else
+
+InstructionSet detectInstructionSet() { return InstructionSet::Scalar; }
+
+#endif /* ENERGY_KERNELS_X86 */
+
+std::atomic<InstructionSet> &activeInstructionSet() {
+  static std::atomic<InstructionSet> instructionSet(
+      EnergyKernels::supportedInstructionSet());
+  return instructionSet;
+}
+
+} // namespace
+
+namespace EnergyKernels {
+
+InstructionSet supportedInstructionSet() {
+  static auto const instructionSet = detectInstructionSet();
+  return instructionSet;
+}
+
+InstructionSet instructionSet() { return activeInstructionSet().load(); }
+
+void limitInstructionSet(InstructionSet limit) {
+  activeInstructionSet().store(std::min(limit, supportedInstructionSet()));
+}
+
+char const *instructionSetName(InstructionSet instructionSet) {
+  switch (instructionSet) {
+  case InstructionSet::AVX512:
+    return "AVX-512";
+  case InstructionSet::AVX2:
+    return "AVX2";
+  default:
+    return "Scalar";
+  }
+}
+
+void totalEnergies(Trajectory const &target, Trajectory const &other,
+                   std::size_t first, std::size_t count, double targetMass,
+                   double otherMass, double *energies) {
+  TrajectoryPair const pair(target, other, first);
+  switch (instructionSet()) {
+#ifdef ENERGY_KERNELS_X86
+  case InstructionSet::AVX512:
+    avx512Energies(pair, count, targetMass, otherMass, energies);
+    break;
+  case InstructionSet::AVX2:
+    avx2Energies(pair, count, targetMass, otherMass, energies);
+    break;
+#endif
+  default:
+    scalarEnergies(pair, 0, count, targetMass, otherMass, energies);
+  }
+}
+
+} // namespace EnergyKernels
@@ -0,0 +1,108 @@
+#include "FractionIntervals.h"
+#include "RandomStream.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// The standard normal quantile of a two-sided 95% interval
+double constexpr Z_95 = 1.959963984540054;
+double constexpr LOWER_QUANTILE = 0.025;
+double constexpr UPPER_QUANTILE = 0.975;
+
+// The draws of a resample are counted a block at a time
+std::size_t constexpr DRAW_BLOCK_SIZE = 256;
+// Uniform draws are compared as 53 bit integers
+double constexpr DRAW_SCALE = 9007199254740992.0;
+
+std::uint64_t drawThreshold(std::size_t count, std::size_t totalCount) {
+  return static_cast<std::uint64_t>(static_cast<double>(count) /
+                                    static_cast<double>(totalCount) *
+                                    DRAW_SCALE);
+}
+
+// The numbers of a resample's draws bound to the black hole and bound to
+// either body, each draw falling below the thresholds with the probabilities
+// of the outcomes
+std::pair<std::size_t, std::size_t>
+resampleCounts(RandomStream const &randomStream, std::uint64_t firstCounter,
+               std::size_t totalCount, std::uint64_t bhThreshold,
+               std::uint64_t boundThreshold) {
+  std::size_t bhCount = 0, boundCount = 0;
+  std::uint64_t draws[DRAW_BLOCK_SIZE];
+  for (std::size_t first = 0; first < totalCount; first += DRAW_BLOCK_SIZE) {
+    auto const blockSize = std::min(DRAW_BLOCK_SIZE, totalCount - first);
+    for (auto i = 0u; i < blockSize; ++i)
+      draws[i] = randomStream.value(firstCounter + first + i) >> 11;
+    for (auto i = 0u; i < blockSize; ++i) {
+      bhCount += draws[i] < bhThreshold;
+      boundCount += draws[i] < boundThreshold;
+    }
+  }
+  return std::make_pair(bhCount, boundCount);
+}
+
+FractionInterval percentileInterval(std::vector<double> &fractions) {
+  std::sort(fractions.begin(), fractions.end());
+  auto const last = static_cast<double>(fractions.size() - 1);
+  return FractionInterval{
+      fractions[static_cast<std::size_t>(std::floor(LOWER_QUANTILE * last))],
+      fractions[static_cast<std::size_t>(std::ceil(UPPER_QUANTILE * last))]};
+}
+
+} // namespace
+
+namespace FractionIntervals {
+
+FractionInterval wilsonInterval(std::size_t count, std::size_t totalCount) {
+  if (totalCount == 0)
+    return FractionInterval{0.0, 1.0};
+
+  auto const n = static_cast<double>(totalCount);
+  auto const fraction = static_cast<double>(count) / n;
+  auto const z2 = Z_95 * Z_95;
+  auto const denominator = 1.0 + z2 / n;
+  auto const centre = (fraction + z2 / (2.0 * n)) / denominator;
+  auto const halfWidth =
+      Z_95 * std::sqrt(fraction * (1.0 - fraction) / n + z2 / (4.0 * n * n)) /
+      denominator;
+  return FractionInterval{std::max(0.0, centre - halfWidth),
+                          std::min(1.0, centre + halfWidth)};
+}
+
+// The percentile intervals of the black hole bound, star bound and unbound
+// fractions over resamples of the runs of a cell
+std::array<FractionInterval, 3>
+bootstrapIntervals(RandomStream const &randomStream, std::size_t bhBoundCount,
+                   std::size_t starBoundCount, std::size_t totalCount,
+                   std::size_t numberOfResamples) {
+  if (totalCount == 0 || numberOfResamples == 0)
+    return {{{0.0, 1.0}, {0.0, 1.0}, {0.0, 1.0}}};
+
+  auto const bhThreshold = drawThreshold(bhBoundCount, totalCount);
+  auto const boundThreshold =
+      drawThreshold(bhBoundCount + starBoundCount, totalCount);
+  auto const n = static_cast<double>(totalCount);
+
+  std::vector<double> bhFractions, starFractions, unboundFractions;
+  bhFractions.reserve(numberOfResamples);
+  starFractions.reserve(numberOfResamples);
+  unboundFractions.reserve(numberOfResamples);
+  for (std::size_t resample = 0; resample < numberOfResamples; ++resample) {
+    auto const counts = resampleCounts(randomStream, resample * totalCount,
+                                       totalCount, bhThreshold, boundThreshold);
+    bhFractions.emplace_back(static_cast<double>(counts.first) / n);
+    starFractions.emplace_back(
+        static_cast<double>(counts.second - counts.first) / n);
+    unboundFractions.emplace_back(
+        static_cast<double>(totalCount - counts.second) / n);
+  }
+  return {{percentileInterval(bhFractions), percentileInterval(starFractions),
+           percentileInterval(unboundFractions)}};
+}
+
+} // namespace FractionIntervals
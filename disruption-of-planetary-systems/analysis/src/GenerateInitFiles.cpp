@@ -1,276 +1,189 @@
 #include "GenerateInitFiles.h"
 
-#include "Body.h"
-#include "BodyCreator.h"
+#include "InitFileSerializer.h"
 #include "InitSimulationParams.h"
-#include "XYZComponents.h"
+#include "SimulationParamsStream.h"
+#include "SweepFiles.h"
+#include "SweepJournal.h"
 
+#include "AsyncFileWriter.h"
 #include "FileManager.h"
+#include "PackedFile.h"
 #include "TaskRunner.h"
+#include "ThreadPool.h"
 
-#define _USE_MATH_DEFINES
-#include <math.h>
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 
 namespace {
 
-using namespace BodyCreator;
+using namespace InitFileSerializer;
 
-std::size_t randomNumber(std::size_t lower, std::size_t higher) {
-  return static_cast<std::size_t>(rand() % (higher - lower) + lower);
-}
+// The number of simulations a thread pulls from the stream at a time
+std::size_t constexpr PARAMETERS_PER_CHUNK = 64;
 
-double randomDouble(double lower, double higher) {
-  return (double)rand() / RAND_MAX * (higher - lower) + lower;
+std::size_t numberOfThreads() {
+  return std::max(1u, std::thread::hardware_concurrency());
 }
 
 std::string formatSimParameter(double value) {
   return std::to_string(static_cast<int>(value)) + ".0";
 }
 
-void generateFileLine(std::string &fileText, double mass,
-                      XYZComponents const &position,
-                      XYZComponents const &velocity) {
-  fileText += "\n  " + std::to_string(mass) + "   " +
-              std::to_string(position.compX()) + "   " +
-              std::to_string(position.compY()) + "   " +
-              std::to_string(position.compZ()) + "   " +
-              std::to_string(velocity.compX()) + "   " +
-              std::to_string(velocity.compY()) + "   " +
-              std::to_string(velocity.compZ());
-}
-
-void generateFileText(std::string &fileText) { (void)(fileText); }
-
-template <typename Body, typename... Bodies>
-void generateFileText(std::string &fileText, Body const &body,
-                      Bodies const &... bodies) {
-  generateFileLine(fileText, body.mass(), body.position(0), body.velocity(0));
-  generateFileText(fileText, bodies...);
-}
-
 } // namespace
 
-InitFileGenerator::InitFileGenerator(std::string const &directory)
-    : m_fileManager(std::make_unique<FileManager>()), m_directory(directory),
+InitFileGenerator::InitFileGenerator(std::string const &directory,
+                                     SweepJournal &journal)
+    : m_directory(directory), m_journal(journal),
       m_taskRunner(TaskRunner::getInstance()) {}
 
 InitFileGenerator::~InitFileGenerator() {}
 
 void InitFileGenerator::resetGenerator(std::size_t numberOfInitFiles) {
-  resetInitSimulationParams(numberOfInitFiles);
+  resetInitFileWriter();
   m_taskRunner.setTask("Generating init files...", 0.0, 10.0);
   m_taskRunner.setNumberOfSteps(numberOfInitFiles);
 }
 
-void InitFileGenerator::resetInitSimulationParams(
-    std::size_t numberOfInitFiles) {
-  m_simulationParams.clear();
-  m_simulationParams.reserve(numberOfInitFiles);
-}
-
-void InitFileGenerator::addInitSimulationParams(
-    InitSimulationParams const &simParameters) {
-  m_simulationParams.emplace_back(simParameters);
-}
+void InitFileGenerator::resetInitFileWriter() {
+  m_recordHandler = nullptr;
+  m_initFileWriter.reset();
+  m_initPack.reset();
 
-std::vector<InitSimulationParams> const &
-InitFileGenerator::simulationParameters() const {
-  return m_simulationParams;
-}
-
-void InitFileGenerator::createFile(std::string const &filename,
-                                   std::string const &fileText) const {
-  m_fileManager->setFilename(m_directory + filename);
-  m_fileManager->createNewFile(fileText);
-}
-
-bool InitFileGenerator::generate(
-    std::vector<std::string> const &pericentres,
-    std::vector<std::string> const &planetDistancesA,
-    std::vector<std::string> const &planetDistancesB,
-    std::size_t numberOfOrientations) {
-  resetGenerator(pericentres.size() * planetDistancesA.size() *
-                 numberOfOrientations);
-  return generateInitFiles(pericentres, planetDistancesA, planetDistancesB,
-                           numberOfOrientations);
-}
-
-bool InitFileGenerator::generateInitFiles(
-    std::vector<std::string> const &pericentres,
-    std::vector<std::string> const &planetDistancesA,
-    std::vector<std::string> const &planetDistancesB,
-    std::size_t numberOfOrientations) {
-  for (auto const &pericentre : pericentres) {
-    for (auto i = 0u; i < planetDistancesA.size(); ++i) {
-      if (m_taskRunner.isRunning())
-        generateInitFiles(pericentre, planetDistancesA, planetDistancesB, i,
-                          numberOfOrientations);
-      else
-        return false;
-    }
-  }
-
-  saveSimulationParameters(m_simulationParams);
-  return true;
-}
-
-void InitFileGenerator::generateInitFiles(
-    std::string const &pericentre,
-    std::vector<std::string> const &planetDistancesA,
-    std::vector<std::string> const &planetDistancesB,
-    std::size_t planetDistanceIndex, std::size_t numberOfOrientations) {
-  if (OtherSimulationSettings::m_hasSinglePlanet) {
-    generate3BodyInitFiles(pericentre, planetDistancesA[planetDistanceIndex],
-                           numberOfOrientations);
+  if (OtherSimulationSettings::m_usePackedFiles) {
+    m_initPack = std::make_unique<PackedFileWriter>(
+        m_directory + SweepFiles::INIT_PACK, true);
+    m_initFileWriter = std::make_unique<AsyncFileWriter>(
+        [this](std::string const &filename, std::string const &fileText) {
+          m_initPack->append(filename, fileText);
+        });
   } else {
-    generate4BodyInitFiles(pericentre, planetDistancesA[planetDistanceIndex],
-                           planetDistancesB[planetDistanceIndex],
-                           numberOfOrientations);
+    m_initFileWriter = std::make_unique<AsyncFileWriter>();
   }
 }
 
-void InitFileGenerator::generate3BodyInitFiles(
-    std::string const &pericentre, std::string const &planetDistance,
-    std::size_t numberOfOrientations) {
-  for (auto index = 1u; index < numberOfOrientations + 1; ++index) {
-    generate3BodyInitFile(pericentre, planetDistance, index);
-    m_taskRunner.reportProgress();
+std::string InitFileGenerator::acquireBuffer() const {
+  if (m_initFileWriter)
+    return m_initFileWriter->acquireBuffer();
+  return std::string();
+}
+
+void InitFileGenerator::writeInitFile(InitSimulationParams const &parameters,
+                                      std::string &&fileText) const {
+  m_journal.recordGenerated(parameters);
+
+  auto const filename = parameters.filename();
+  if (m_recordHandler)
+    m_recordHandler(parameters, std::move(fileText));
+  else if (m_initPack)
+    m_initFileWriter->write(filename, std::move(fileText));
+  else
+    m_initFileWriter->write(m_directory + filename + ".init",
+                            std::move(fileText));
+}
+
+bool InitFileGenerator::generate(SweepDefinition const &sweep) {
+  resetGenerator(sweep.numberOfSimulations());
+  return generateInitFiles(sweep);
+}
+
+bool InitFileGenerator::generate(SweepDefinition const &sweep,
+                                 InitRecordHandler const &recordHandler) {
+  // The records are handed over instead of being written to disk, and the
+  // progress is reported by whoever consumes them
+  m_initFileWriter.reset();
+  m_initPack.reset();
+  m_recordHandler = recordHandler;
+
+  return generateInitFiles(sweep);
+}
+
+bool InitFileGenerator::generateInitFiles(SweepDefinition const &sweep) {
+  auto const parametersFilename = m_directory + "simulation_parameters.txt";
+  std::ofstream parametersFile(parametersFilename);
+  if (!parametersFile.is_open())
+    throw std::runtime_error(
+        "Failed to open file " + parametersFilename +
+        " for writing. Please make sure the file is closed.");
+  parametersFile << generateSimulationParametersHeader();
+
+  // The init files follow the order of the sweep, which may be ordered by
+  // cost, while the parameters file is always written in run ID order
+  auto const sweepInRunOrder = sweep.inRunOrder();
+  SimulationParamsStream parametersStream(sweep);
+  SimulationParamsStream orderedParametersStream(sweepInRunOrder);
+
+  std::mutex errorMutex;
+  std::string errorMessage;
+  auto const runTask = [&](std::function<void()> const &task) {
+    try {
+      task();
+    } catch (std::runtime_error const &error) {
+      std::unique_lock<std::mutex> lock(errorMutex);
+      errorMessage = error.what();
+      m_taskRunner.stopTask();
+    }
+  };
+  {
+    ThreadPool pool(numberOfThreads() + 1);
+    pool.addToQueue([&]() {
+      runTask([&]() {
+        writeSimulationParameters(orderedParametersStream, parametersFile);
+      });
+    });
+    for (auto i = 0u; i < numberOfThreads(); ++i)
+      pool.addToQueue([&]() {
+        runTask([&]() { generateInitFiles(parametersStream); });
+      });
   }
-}
+  if (m_initFileWriter)
+    m_initFileWriter->finish();
+  if (m_initPack)
+    m_initPack->flush();
 
-void InitFileGenerator::generate3BodyInitFile(std::string const &pericentre,
-                                              std::string const &planetDistance,
-                                              std::size_t orientationIndex) {
-  auto const phi = randomNumber(0, 360);
-  auto const inclination = randomNumber(0, 360);
-  generate3BodyInitFile(pericentre, planetDistance, orientationIndex, phi,
-                        inclination);
+  if (!errorMessage.empty())
+    throw std::runtime_error(errorMessage);
+  return m_taskRunner.isRunning();
 }
 
-void InitFileGenerator::generate3BodyInitFile(std::string const &pericentre,
-                                              std::string const &planetDistance,
-                                              std::size_t orientationIndex,
-                                              std::size_t phi,
-                                              std::size_t inclination) {
-  generate3BodyInitFile(
-      generate3BodyInitFilename(pericentre, planetDistance, orientationIndex),
-      std::stod(pericentre), std::stod(planetDistance), orientationIndex, phi,
-      inclination);
-}
-
-void InitFileGenerator::generate3BodyInitFile(
-    std::string const &filename, double pericentre, double planetDistance,
-    std::size_t orientationIndex, std::size_t phi, std::size_t inclination) {
-  auto const star =
-      createStar(pericentre, randomizeTrueAnomaly(pericentre, planetDistance));
-  auto const planet =
-      createPlanet(*star, planetDistance, orientationIndex, phi, inclination);
-
-  auto fileText = generateInitHeader(filename, pericentre, planetDistance);
-  generateFileText(fileText, *blackHole(), *star, *planet);
-  createFile(filename + ".init", fileText);
-
-  addInitSimulationParams(InitSimulationParams(filename, pericentre,
-                                               planetDistance, orientationIndex,
-                                               phi, inclination));
-}
-
-void InitFileGenerator::generate4BodyInitFiles(
-    std::string const &pericentre, std::string const &planetDistanceA,
-    std::string const &planetDistanceB, std::size_t numberOfOrientations) {
-  for (auto index = 1u; index < numberOfOrientations + 1; ++index) {
-    generate4BodyInitFile(pericentre, planetDistanceA, planetDistanceB, index);
-    m_taskRunner.reportProgress();
+void InitFileGenerator::generateInitFiles(
+    SimulationParamsStream &parametersStream) {
+  std::vector<InitSimulationParams> parameters;
+  parameters.reserve(PARAMETERS_PER_CHUNK);
+
+  while (m_taskRunner.isRunning() &&
+         parametersStream.next(parameters, PARAMETERS_PER_CHUNK)) {
+    for (auto const &simParameters : parameters) {
+      generateInitFile(simParameters);
+      if (!m_recordHandler)
+        m_taskRunner.reportProgress();
+    }
   }
 }
 
-void InitFileGenerator::generate4BodyInitFile(
-    std::string const &pericentre, std::string const &planetDistanceA,
-    std::string const &planetDistanceB, std::size_t orientationIndex) {
-  auto const phi = randomNumber(0, 360);
-  auto const inclination = randomNumber(0, 360);
-  generate4BodyInitFile(pericentre, planetDistanceA, planetDistanceB,
-                        orientationIndex, phi, inclination);
-}
-
-void InitFileGenerator::generate4BodyInitFile(
-    std::string const &pericentre, std::string const &planetDistanceA,
-    std::string const &planetDistanceB, std::size_t orientationIndex,
-    std::size_t phi, std::size_t inclination) {
-  generate4BodyInitFile(
-      generate4BodyInitFilename(pericentre, planetDistanceA, planetDistanceB,
-                                orientationIndex),
-      std::stod(pericentre), std::stod(planetDistanceA),
-      std::stod(planetDistanceB), orientationIndex, phi, inclination);
-}
-
-void InitFileGenerator::generate4BodyInitFile(
-    std::string const &filename, double pericentre, double planetDistanceA,
-    double planetDistanceB, std::size_t orientationIndex, std::size_t phi,
-    std::size_t inclination) {
-  auto const largestPlanetDistance =
-      planetDistanceA > planetDistanceB ? planetDistanceA : planetDistanceB;
-
-  auto const star = createStar(
-      pericentre, randomizeTrueAnomaly(pericentre, largestPlanetDistance));
-  auto const planetA =
-      createPlanet(*star, planetDistanceA, orientationIndex, phi, inclination);
-  auto const planetB =
-      createPlanet(*star, planetDistanceB, orientationIndex, phi, inclination);
-
-  auto fileText =
-      generateInitHeader(filename, pericentre, largestPlanetDistance);
-  generateFileText(fileText, *blackHole(), *star, *planetA, *planetB);
-  createFile(filename + ".init", fileText);
-
-  addInitSimulationParams(InitSimulationParams(
-      filename, pericentre, planetDistanceA, planetDistanceB, orientationIndex,
-      phi, inclination));
-}
-
-std::string InitFileGenerator::generate3BodyInitFilename(
-    std::string const &pericentre, std::string const &planetDistance,
-    std::size_t const &orientationIndex) const {
-  return "p" + pericentre + "_r" + planetDistance + "_o" +
-         std::to_string(orientationIndex);
-}
-
-std::string InitFileGenerator::generate4BodyInitFilename(
-    std::string const &pericentre, std::string const &planetDistanceA,
-    std::string const &planetDistanceB,
-    std::size_t const &orientationIndex) const {
-  return "p" + pericentre + "_r" + planetDistanceA + "+" + planetDistanceB +
-         "_o" + std::to_string(orientationIndex);
-}
-
-std::string InitFileGenerator::generateInitHeader(std::string const &filename,
-                                                  double pericentre,
-                                                  double planetDistance) const {
-  auto const numBodies = std::to_string(InitHeaderData::numberOfBodies());
-  auto const step =
-      std::to_string(InitHeaderData::timeStep(pericentre, planetDistance));
-  auto const numTimeSteps = std::to_string(
-      InitHeaderData::numberOfTimeStep(pericentre, planetDistance));
-  return "-1 " + numBodies + " " + step + " " + numTimeSteps +
-         " 0.000000 0.000000 1.d0 1.d-3 0.d0 0 " + filename + ".out 1 1";
-}
+void InitFileGenerator::writeSimulationParameters(
+    SimulationParamsStream &parametersStream,
+    std::ostream &parametersFile) const {
+  std::vector<InitSimulationParams> parameters;
+  parameters.reserve(PARAMETERS_PER_CHUNK);
 
-void InitFileGenerator::saveSimulationParameters(
-    std::vector<InitSimulationParams> const &parameters) const {
-  createFile("simulation_parameters.txt",
-             generateSimulationParametersText(parameters));
+  while (m_taskRunner.isRunning() &&
+         parametersStream.next(parameters, PARAMETERS_PER_CHUNK))
+    for (auto const &simParameters : parameters)
+      parametersFile << generateSimulationParametersLine(simParameters);
 }
 
-std::string InitFileGenerator::generateSimulationParametersText(
-    std::vector<InitSimulationParams> const &parameters) const {
-  std::string fileText = generateSimulationParametersHeader(parameters);
-  for (auto const &parameterSet : parameters)
-    fileText += generateSimulationParametersLine(parameterSet);
-  return std::move(fileText);
+void InitFileGenerator::generateInitFile(
+    InitSimulationParams const &parameters) const {
+  auto fileText = acquireBuffer();
+  serializeInitRecord(fileText, parameters);
+  writeInitFile(parameters, std::move(fileText));
 }
 
-std::string InitFileGenerator::generateSimulationParametersHeader(
-    std::vector<InitSimulationParams> const &parameters) const {
+std::string InitFileGenerator::generateSimulationParametersHeader() const {
   if (OtherSimulationSettings::m_hasSinglePlanet)
     return "Index  Pericentre  PlanetDistance  Phi  Inclination";
   return "Index  Pericentre  PlanetDistanceA  PlanetDistanceB  Phi  "
@@ -293,18 +206,3 @@ std::string InitFileGenerator::generateSimulationPlanetDistancesSubLine(
     return std::move(subLine);
   return subLine + " " + formatSimParameter(parameters.m_planetDistances[1]);
 }
-
-double InitFileGenerator::randomizeTrueAnomaly(double pericentre,
-                                               double planetDistance) const {
-  auto const trueAnomaly =
-      InitHeaderData::trueAnomaly(pericentre, planetDistance);
-
-  auto const x = 2.0 * pericentre * cos(trueAnomaly) / (1 + cos(trueAnomaly));
-  auto const y = 2.0 * pericentre * sin(trueAnomaly) / (1 + cos(trueAnomaly));
-  auto const xyz = XYZComponents(std::move(x), std::move(y), 0.0);
-
-  auto const deltaAnomaly =
-      atan(planetDistance * sin(M_PI - trueAnomaly) /
-           (xyz.magnitude() - planetDistance * cos(M_PI - trueAnomaly)));
-  return randomDouble(trueAnomaly - deltaAnomaly, trueAnomaly + deltaAnomaly);
-}
@@ -0,0 +1,70 @@
+#include "Histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+Histogram::Histogram(double minimum, double maximum, std::size_t numberOfBins,
+                     HistogramScale scale)
+    : m_minimum(minimum), m_maximum(maximum), m_scale(scale),
+      m_binCounts(numberOfBins, 0), m_underflow(0), m_overflow(0) {
+  if (numberOfBins == 0 || !(minimum < maximum) ||
+      (scale == HistogramScale::Logarithmic && !(minimum > 0.0)))
+    throw std::runtime_error("The histogram bins are invalid.");
+}
+
+Histogram::~Histogram() {}
+
+void Histogram::add(double value) {
+  if (!(value >= m_minimum)) {
+    ++m_underflow;
+    return;
+  }
+  if (value >= m_maximum) {
+    ++m_overflow;
+    return;
+  }
+
+  auto const position = (scaled(value) - scaled(m_minimum)) /
+                        (scaled(m_maximum) - scaled(m_minimum));
+  auto const bin = static_cast<std::size_t>(
+      position * static_cast<double>(m_binCounts.size()));
+  // Rounding can place a value just below the maximum past the last bin
+  ++m_binCounts[std::min(bin, m_binCounts.size() - 1)];
+}
+
+void Histogram::merge(Histogram const &otherHistogram) {
+  if (otherHistogram.m_binCounts.size() != m_binCounts.size() ||
+      otherHistogram.m_minimum != m_minimum ||
+      otherHistogram.m_maximum != m_maximum ||
+      otherHistogram.m_scale != m_scale)
+    throw std::runtime_error("Histograms with different bins can not merge.");
+
+  for (auto i = 0u; i < m_binCounts.size(); ++i)
+    m_binCounts[i] += otherHistogram.m_binCounts[i];
+  m_underflow += otherHistogram.m_underflow;
+  m_overflow += otherHistogram.m_overflow;
+}
+
+std::size_t Histogram::numberOfBins() const { return m_binCounts.size(); }
+
+// The lower edge of a bin, or the maximum for the index past the last bin
+double Histogram::binEdge(std::size_t index) const {
+  auto const position =
+      static_cast<double>(index) / static_cast<double>(m_binCounts.size());
+  auto const edge =
+      scaled(m_minimum) + position * (scaled(m_maximum) - scaled(m_minimum));
+  return m_scale == HistogramScale::Logarithmic ? std::pow(10.0, edge) : edge;
+}
+
+std::vector<std::uint64_t> const &Histogram::binCounts() const {
+  return m_binCounts;
+}
+
+std::uint64_t Histogram::underflow() const { return m_underflow; }
+
+std::uint64_t Histogram::overflow() const { return m_overflow; }
+
+double Histogram::scaled(double value) const {
+  return m_scale == HistogramScale::Logarithmic ? std::log10(value) : value;
+}
@@ -0,0 +1,78 @@
+#include "InitFileSerializer.h"
+
+#include "Body.h"
+#include "BodyCreator.h"
+#include "InitSimulationParams.h"
+#include "XYZComponents.h"
+
+#include <charconv>
+#include <stdexcept>
+
+namespace {
+
+// Large enough for the shortest round-trip form of any double
+std::size_t constexpr NUMBER_BUFFER_SIZE = 32;
+
+template <typename Number>
+void appendValue(std::string &buffer, Number value) {
+  char characters[NUMBER_BUFFER_SIZE];
+  auto const result =
+      std::to_chars(characters, characters + NUMBER_BUFFER_SIZE, value);
+  if (result.ec != std::errc())
+    throw std::runtime_error("Failed to format a number for an init file.");
+  buffer.append(characters, result.ptr);
+}
+
+} // namespace
+
+namespace InitFileSerializer {
+
+void appendNumber(std::string &buffer, double value) {
+  appendValue(buffer, value);
+}
+
+void appendNumber(std::string &buffer, std::size_t value) {
+  appendValue(buffer, value);
+}
+
+void serializeInitRecord(std::string &buffer,
+                         InitSimulationParams const &parameters,
+                         std::size_t timeStepDivisor) {
+  serializeHeader(buffer, parameters.filename(), parameters.m_pericentre,
+                  parameters.largestPlanetDistance(), timeStepDivisor);
+  for (auto const &body : BodyCreator::createBodies(parameters))
+    serializeBody(buffer, *body);
+}
+
+void serializeHeader(std::string &buffer, std::string const &filename,
+                     double pericentre, double planetDistance,
+                     std::size_t timeStepDivisor) {
+  buffer += "-1 ";
+  appendNumber(buffer, InitHeaderData::numberOfBodies());
+  buffer += ' ';
+  appendNumber(buffer, InitHeaderData::timeStep(pericentre, planetDistance) /
+                           static_cast<double>(timeStepDivisor));
+  buffer += ' ';
+  appendNumber(buffer,
+               InitHeaderData::numberOfTimeStep(pericentre, planetDistance) *
+                   timeStepDivisor);
+  buffer += " 0.000000 0.000000 1.d0 1.d-3 0.d0 0 ";
+  buffer += filename;
+  buffer += ".out 1 1";
+}
+
+void serializeBody(std::string &buffer, Body const &body) {
+  auto const position = body.position(0);
+  auto const velocity = body.velocity(0);
+
+  buffer += "\n  ";
+  appendNumber(buffer, body.mass());
+  for (auto const value :
+       {position.compX(), position.compY(), position.compZ(), velocity.compX(),
+        velocity.compY(), velocity.compZ()}) {
+    buffer += "   ";
+    appendNumber(buffer, value);
+  }
+}
+
+} // namespace InitFileSerializer
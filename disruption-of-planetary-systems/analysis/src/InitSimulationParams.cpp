@@ -1,6 +1,10 @@
 #include "InitSimulationParams.h"
+#include "InitFileSerializer.h"
+#include "RandomStream.h"
 
 #include <algorithm>
+#include <thread>
+#include <type_traits>
 
 #define _USE_MATH_DEFINES
 #include <math.h>
@@ -112,38 +116,127 @@ std::map<std::pair<double, double>, InitHeaderParams>
 /*
 The simulation parameters used to calculate body positions and velocities
 */
-InitSimulationParams::InitSimulationParams(
-    std::string const &filename, double pericentre, double planetDistance,
-    std::size_t orientationIndex, std::size_t phi, std::size_t inclination)
-    : m_filename(filename), m_pericentre(pericentre),
-      m_orientationIndex(orientationIndex), m_phi(phi),
-      m_inclination(inclination) {
-  m_planetDistances.emplace_back(planetDistance);
-}
+static_assert(std::is_trivially_copyable<InitSimulationParams>::value,
+              "InitSimulationParams must remain trivially copyable.");
+
+InitSimulationParams::InitSimulationParams(std::uint64_t runId,
+                                           double pericentre,
+                                           double planetDistance,
+                                           std::size_t orientationIndex,
+                                           std::size_t phi,
+                                           std::size_t inclination)
+    : m_runId(runId), m_pericentre(pericentre),
+      m_planetDistances{planetDistance, 0.0},
+      m_orientationIndex(static_cast<std::uint32_t>(orientationIndex)),
+      m_phi(static_cast<std::uint16_t>(phi)),
+      m_inclination(static_cast<std::uint16_t>(inclination)),
+      m_numberOfPlanets(1) {}
 
 InitSimulationParams::InitSimulationParams(
-    std::string const &filename, double pericentre, double planetDistanceA,
+    std::uint64_t runId, double pericentre, double planetDistanceA,
     double planetDistanceB, std::size_t orientationIndex, std::size_t phi,
     std::size_t inclination)
-    : m_filename(filename), m_pericentre(pericentre),
-      m_orientationIndex(orientationIndex), m_phi(phi),
-      m_inclination(inclination) {
-  m_planetDistances.emplace_back(planetDistanceA);
-  m_planetDistances.emplace_back(planetDistanceB);
-}
-
-InitSimulationParams::~InitSimulationParams() {}
+    : m_runId(runId), m_pericentre(pericentre),
+      m_planetDistances{planetDistanceA, planetDistanceB},
+      m_orientationIndex(static_cast<std::uint32_t>(orientationIndex)),
+      m_phi(static_cast<std::uint16_t>(phi)),
+      m_inclination(static_cast<std::uint16_t>(inclination)),
+      m_numberOfPlanets(2) {}
 
 bool InitSimulationParams::operator!=(
     InitSimulationParams const &otherParams) const {
-  return m_filename != otherParams.m_filename;
+  return m_runId != otherParams.m_runId;
+}
+
+std::string InitSimulationParams::filename() const {
+  std::string filename("p");
+  InitFileSerializer::appendNumber(filename, m_pericentre);
+  filename += "_r";
+  InitFileSerializer::appendNumber(filename, m_planetDistances[0]);
+  if (m_numberOfPlanets == 2) {
+    filename += '+';
+    InitFileSerializer::appendNumber(filename, m_planetDistances[1]);
+  }
+  filename += "_o";
+  InitFileSerializer::appendNumber(
+      filename, static_cast<std::size_t>(m_orientationIndex));
+  return filename;
+}
+
+double InitSimulationParams::largestPlanetDistance() const {
+  return std::max(m_planetDistances[0], m_planetDistances[1]);
+}
+
+RandomStream InitSimulationParams::randomStream() const {
+  if (m_numberOfPlanets == 1)
+    return RandomStream(OtherSimulationSettings::m_sweepSeed, m_pericentre,
+                        m_planetDistances[0], m_orientationIndex);
+  return RandomStream(OtherSimulationSettings::m_sweepSeed, m_pericentre,
+                      m_planetDistances[0], m_planetDistances[1],
+                      m_orientationIndex);
 }
 
 /*
 Other settings used for the simulation
 */
+std::size_t OtherSimulationSettings::numberOfIntegrators() {
+  if (m_numberOfIntegrators > 0)
+    return m_numberOfIntegrators;
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Runs are never stopped early when comparing integrators, as the built-in
+// integrator always runs to the end and the final states must be compared at
+// the same time
+std::size_t OtherSimulationSettings::earlyTerminationWindow() {
+  if (m_integratorBackend == IntegratorBackend::Comparison)
+    return 0;
+  return m_earlyTerminationWindow;
+}
+
+std::uint64_t OtherSimulationSettings::m_sweepSeed = 0;
+
 bool OtherSimulationSettings::m_hasSinglePlanet = true;
 
 bool OtherSimulationSettings::m_combinePlanetResults = true;
 
 bool OtherSimulationSettings::m_useDefaults = true;
+
+bool OtherSimulationSettings::m_usePackedFiles = false;
+
+std::size_t OtherSimulationSettings::m_numberOfIntegrators = 0;
+
+bool OtherSimulationSettings::m_deleteOutFiles = false;
+
+bool OtherSimulationSettings::m_resumeSweep = false;
+
+IntegratorBackend OtherSimulationSettings::m_integratorBackend =
+    IntegratorBackend::External;
+
+std::size_t OtherSimulationSettings::m_earlyTerminationWindow = 0;
+
+std::size_t OtherSimulationSettings::m_wallTimeLimit = 0;
+
+std::size_t OtherSimulationSettings::m_cpuTimeLimit = 0;
+
+std::size_t OtherSimulationSettings::m_memoryLimit = 0;
+
+std::size_t OtherSimulationSettings::m_stallTimeLimit = 0;
+
+std::size_t OtherSimulationSettings::m_maximumRetries = 1;
+
+std::string OtherSimulationSettings::m_coordinatorAddress;
+
+std::size_t OtherSimulationSettings::m_numberOfShards = 0;
+
+std::size_t OtherSimulationSettings::m_mockTimeSteps = 0;
+
+std::size_t OtherSimulationSettings::m_mockLatency = 0;
+
+std::string OtherSimulationSettings::m_replayDirectory;
+
+bool OtherSimulationSettings::m_writeOrbitalElements = false;
+
+std::size_t OtherSimulationSettings::m_bootstrapResamples = 2000;
+
+ResultsFormat OtherSimulationSettings::m_resultsFormat = ResultsFormat::Text;
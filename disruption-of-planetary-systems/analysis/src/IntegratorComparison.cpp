@@ -0,0 +1,141 @@
+#include "IntegratorComparison.h"
+#include "Body.h"
+#include "InitFileSerializer.h"
+#include "InitSimulationParams.h"
+#include "XYZComponents.h"
+
+#include "FileManager.h"
+#include "Logger.h"
+
+#include <cmath>
+#include <limits>
+
+namespace {
+
+using namespace InitFileSerializer;
+
+// The final separation of two bodies relative to the external trajectory
+double separationError(std::vector<std::unique_ptr<Body>> const &externalBodies,
+                       std::vector<std::unique_ptr<Body>> const &internalBodies,
+                       std::size_t bodyIndex, std::size_t otherIndex) {
+  auto const externalStep = externalBodies[bodyIndex]->numberOfTimeSteps() - 1;
+  auto const internalStep = internalBodies[bodyIndex]->numberOfTimeSteps() - 1;
+  auto externalSeparation = externalBodies[bodyIndex]->position(externalStep) -
+                            externalBodies[otherIndex]->position(externalStep);
+  auto const internalSeparation =
+      internalBodies[bodyIndex]->position(internalStep) -
+      internalBodies[otherIndex]->position(internalStep);
+  return externalSeparation.relativeMag(internalSeparation) /
+         externalSeparation.magnitude();
+}
+
+char const *classification(RunOutcome const &outcome) {
+  if (outcome.m_starBound)
+    return "Star";
+  if (outcome.m_bhBound)
+    return "BlackHole";
+  return "Unbound";
+}
+
+bool sameClassification(RunOutcome const &outcomeA,
+                        RunOutcome const &outcomeB) {
+  return outcomeA.m_starBound == outcomeB.m_starBound &&
+         outcomeA.m_bhBound == outcomeB.m_bhBound;
+}
+
+double relativeError(double externalValue, double internalValue) {
+  if (externalValue == 0.0)
+    return internalValue == 0.0 ? 0.0
+                                : std::numeric_limits<double>::infinity();
+  return std::abs(internalValue - externalValue) / std::abs(externalValue);
+}
+
+} // namespace
+
+IntegratorComparison::IntegratorComparison(std::string const &directory)
+    : m_directory(directory), m_numberOfPlanets(0), m_numberOfAgreements(0) {}
+
+IntegratorComparison::~IntegratorComparison() {}
+
+void IntegratorComparison::reset() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_comparisonLines.clear();
+  m_numberOfPlanets = 0;
+  m_numberOfAgreements = 0;
+}
+
+void IntegratorComparison::addComparison(
+    InitSimulationParams const &parameters,
+    std::vector<std::unique_ptr<Body>> const &externalBodies,
+    std::vector<std::unique_ptr<Body>> const &internalBodies,
+    std::vector<RunOutcome> const &externalOutcomes,
+    std::vector<RunOutcome> const &internalOutcomes) {
+  auto const filename = parameters.filename();
+  auto const starSeparationError =
+      separationError(externalBodies, internalBodies, 1, 0);
+
+  std::string lines;
+  auto numberOfAgreements = 0u;
+  for (auto i = 0u; i < externalOutcomes.size(); ++i) {
+    lines += generateComparisonLine(
+        filename, i, starSeparationError,
+        separationError(externalBodies, internalBodies, i + 2, 1),
+        externalOutcomes[i], internalOutcomes[i]);
+    if (sameClassification(externalOutcomes[i], internalOutcomes[i]))
+      ++numberOfAgreements;
+  }
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_comparisonLines[parameters.m_runId] = std::move(lines);
+  m_numberOfPlanets += externalOutcomes.size();
+  m_numberOfAgreements += numberOfAgreements;
+}
+
+std::string IntegratorComparison::generateComparisonLine(
+    std::string const &filename, std::size_t planetIndex,
+    double starSeparationError, double planetSeparationError,
+    RunOutcome const &externalOutcome,
+    RunOutcome const &internalOutcome) const {
+  std::string line = "\n" + filename + " ";
+  appendNumber(line, planetIndex + 1);
+  for (auto const value : {starSeparationError, planetSeparationError}) {
+    line += ' ';
+    appendNumber(line, value);
+  }
+  line += ' ';
+  line += classification(externalOutcome);
+  line += ' ';
+  line += classification(internalOutcome);
+  for (auto const value :
+       {relativeError(externalOutcome.m_semiMajorStar,
+                      internalOutcome.m_semiMajorStar),
+        relativeError(externalOutcome.m_eccentricityStar,
+                      internalOutcome.m_eccentricityStar)}) {
+    line += ' ';
+    appendNumber(line, value);
+  }
+  return line;
+}
+
+void IntegratorComparison::save() const {
+  std::string fileText =
+      "Filename  Planet  StarSeparationError  PlanetSeparationError  "
+      "ExternalClassification  InternalClassification  SemiMajorStarError  "
+      "EccentricityStarError";
+  std::size_t numberOfPlanets, numberOfAgreements;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (auto const &lines : m_comparisonLines)
+      fileText += lines.second;
+    numberOfPlanets = m_numberOfPlanets;
+    numberOfAgreements = m_numberOfAgreements;
+  }
+
+  FileManager(m_directory + "integrator_comparison.txt")
+      .createNewFile(fileText);
+  Logger::getInstance().addLog(
+      LogType::Info, "The built-in integrator agreed with NewARC.out on the "
+                     "classification of " +
+                         std::to_string(numberOfAgreements) + " of " +
+                         std::to_string(numberOfPlanets) + " planets.");
+}
@@ -0,0 +1,486 @@
+#include "IntegratorScheduler.h"
+
+#ifdef __linux__
+
+#include "InitFileSerializer.h"
+
+#include "Logger.h"
+
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+
+namespace {
+
+// How often running integrators are polled for completion
+std::chrono::milliseconds constexpr POLL_INTERVAL(20);
+
+// How long integrators are given to exit once asked to, before being killed
+std::chrono::seconds constexpr TERMINATION_TIMEOUT(5);
+
+std::string systemError(std::string const &message) {
+  return message + ": " + std::strerror(errno);
+}
+
+// The helper which sets the rlimits of an integrator and then execs it, found
+// next to the executable of this process
+char const *const LAUNCHER_NAME = "IntegratorLauncher";
+
+// The exit status of the helper when a limit cannot be set
+int constexpr LIMIT_FAILURE = 125;
+
+void createDirectory(std::string const &directory) {
+  if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+    throw std::runtime_error(
+        systemError("Failed to create directory " + directory));
+}
+
+class FileActions {
+public:
+  FileActions() { posix_spawn_file_actions_init(&m_actions); }
+  ~FileActions() { posix_spawn_file_actions_destroy(&m_actions); }
+
+  posix_spawn_file_actions_t *get() { return &m_actions; }
+
+private:
+  posix_spawn_file_actions_t m_actions;
+};
+
+// Starts each integrator in a process group of its own
+class SpawnAttributes {
+public:
+  SpawnAttributes() {
+    posix_spawnattr_init(&m_attributes);
+    posix_spawnattr_setflags(&m_attributes, POSIX_SPAWN_SETPGROUP);
+    posix_spawnattr_setpgroup(&m_attributes, 0);
+  }
+  ~SpawnAttributes() { posix_spawnattr_destroy(&m_attributes); }
+
+  posix_spawnattr_t *get() { return &m_attributes; }
+
+private:
+  posix_spawnattr_t m_attributes;
+};
+
+// Signals an integrator along with any processes it has started
+void signalIntegrator(pid_t pid, int signalNumber) {
+  kill(-pid, signalNumber);
+}
+
+bool hasResourceLimits() {
+  return OtherSimulationSettings::m_cpuTimeLimit > 0 ||
+         OtherSimulationSettings::m_memoryLimit > 0;
+}
+
+std::string launcherPath() {
+  char executable[PATH_MAX];
+  auto const length =
+      readlink("/proc/self/exe", executable, sizeof(executable) - 1);
+  if (length < 0)
+    throw std::runtime_error(systemError("Failed to locate this executable"));
+
+  std::string const path(executable, static_cast<std::size_t>(length));
+  auto const launcher = path.substr(0, path.rfind('/') + 1) + LAUNCHER_NAME;
+  if (access(launcher.c_str(), X_OK) != 0)
+    throw std::runtime_error(
+        systemError("Failed to find the integrator launcher " + launcher));
+  return launcher;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point const &time) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - time)
+      .count();
+}
+
+} // namespace
+
+IntegratorScheduler::IntegratorScheduler(
+    std::string const &directory, std::size_t numberOfWorkers,
+    CompletionHandler const &completionHandler,
+    std::function<bool()> const &keepRunning)
+    : m_directory(directory), m_executable(directory + "NewARC.out"),
+      m_running(0), m_completionHandler(completionHandler),
+      m_keepRunning(keepRunning) {
+  if (hasResourceLimits())
+    m_launcher = launcherPath();
+  createDirectory(m_directory + "scratch");
+
+  m_workers.reserve(numberOfWorkers);
+  for (auto i = 0u; i < numberOfWorkers; ++i) {
+    auto const scratchDirectory =
+        m_directory + "scratch/worker" + std::to_string(i) + "/";
+    createDirectory(scratchDirectory);
+    m_workers.emplace_back(
+        Worker{scratchDirectory, -1, InitSimulationParams(0, 0.0, 0.0, 0, 0, 0),
+               std::chrono::steady_clock::time_point(), nullptr, false,
+               std::chrono::steady_clock::time_point(), 0, std::string(),
+               false, 0, std::chrono::steady_clock::time_point()});
+  }
+}
+
+IntegratorScheduler::~IntegratorScheduler() {
+  terminateAll();
+
+  for (auto const &worker : m_workers) {
+    unlink((worker.m_scratchDirectory + "data.log").c_str());
+    rmdir(worker.m_scratchDirectory.c_str());
+  }
+  rmdir((m_directory + "scratch").c_str());
+}
+
+std::size_t IntegratorScheduler::numberOfWorkers() const {
+  return m_workers.size();
+}
+
+bool IntegratorScheduler::submitFile(InitSimulationParams const &parameters,
+                                     std::string const &initFilename) {
+  auto const worker = acquireWorker();
+  if (!worker)
+    return false;
+
+  auto const inputDescriptor =
+      open(initFilename.c_str(), O_RDONLY | O_CLOEXEC);
+  if (inputDescriptor < 0)
+    throw std::runtime_error(systemError("Failed to open " + initFilename));
+
+  launch(*worker, parameters, inputDescriptor, 0);
+  return true;
+}
+
+bool IntegratorScheduler::submitRecord(InitSimulationParams const &parameters,
+                                       std::string const &initRecord) {
+  auto const worker = acquireWorker();
+  if (!worker)
+    return false;
+
+  launchRecord(*worker, parameters, initRecord, 0);
+  return true;
+}
+
+IntegratorScheduler::Worker *IntegratorScheduler::acquireWorker() {
+  for (launchRetries(); m_running == m_workers.size(); launchRetries())
+    if (!waitForWorker())
+      return nullptr;
+  return &idleWorker();
+}
+
+IntegratorScheduler::Worker &IntegratorScheduler::idleWorker() {
+  for (auto &worker : m_workers)
+    if (worker.m_pid < 0)
+      return worker;
+  throw std::runtime_error("No integrator worker is available.");
+}
+
+void IntegratorScheduler::launchRecord(Worker &worker,
+                                       InitSimulationParams const &parameters,
+                                       std::string const &initRecord,
+                                       std::size_t attempt) {
+  // An init record is far smaller than the pipe capacity, so it can be written
+  // before the integrator starts reading
+  int pipeDescriptors[2];
+  if (pipe2(pipeDescriptors, O_CLOEXEC) != 0)
+    throw std::runtime_error(systemError("Failed to create a pipe"));
+
+  auto const record = initRecord + "\n";
+  auto const written =
+      write(pipeDescriptors[1], record.data(), record.size());
+  close(pipeDescriptors[1]);
+  if (written != static_cast<ssize_t>(record.size())) {
+    close(pipeDescriptors[0]);
+    throw std::runtime_error("Failed to pass the init record of " +
+                             parameters.filename() + " to the integrator.");
+  }
+
+  launch(worker, parameters, pipeDescriptors[0], attempt);
+}
+
+void IntegratorScheduler::launchRetries() {
+  while (!m_retries.empty() && m_running < m_workers.size()) {
+    auto const retry = m_retries.front();
+    m_retries.pop_front();
+
+    // Every retry halves the time step again
+    std::string initRecord;
+    InitFileSerializer::serializeInitRecord(
+        initRecord, retry.m_parameters, std::size_t(1) << retry.m_attempt);
+    launchRecord(idleWorker(), retry.m_parameters, initRecord,
+                 retry.m_attempt);
+  }
+}
+
+void IntegratorScheduler::launch(Worker &worker,
+                                 InitSimulationParams const &parameters,
+                                 int inputDescriptor, std::size_t attempt) {
+  auto const logFilename = worker.m_scratchDirectory + "data.log";
+
+  FileActions actions;
+  posix_spawn_file_actions_adddup2(actions.get(), inputDescriptor,
+                                   STDIN_FILENO);
+  posix_spawn_file_actions_addopen(actions.get(), STDOUT_FILENO,
+                                   logFilename.c_str(),
+                                   O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  posix_spawn_file_actions_addchdir_np(actions.get(),
+                                       worker.m_scratchDirectory.c_str());
+
+  // The launcher replaces itself with the integrator, which keeps its pid
+  auto const cpuTimeLimit =
+      std::to_string(OtherSimulationSettings::m_cpuTimeLimit);
+  auto const memoryLimit =
+      std::to_string(OtherSimulationSettings::m_memoryLimit);
+  std::vector<char *> arguments;
+  if (!m_launcher.empty()) {
+    arguments.emplace_back(const_cast<char *>(m_launcher.c_str()));
+    arguments.emplace_back(const_cast<char *>(cpuTimeLimit.c_str()));
+    arguments.emplace_back(const_cast<char *>(memoryLimit.c_str()));
+  }
+  arguments.emplace_back(const_cast<char *>(m_executable.c_str()));
+  arguments.emplace_back(nullptr);
+
+  SpawnAttributes attributes;
+  pid_t pid;
+  auto const error = posix_spawn(&pid, arguments.front(), actions.get(),
+                                 attributes.get(), arguments.data(), environ);
+  close(inputDescriptor);
+  if (error != 0)
+    throw std::runtime_error("Failed to start " + m_executable + ": " +
+                             std::strerror(error));
+
+  worker.m_pid = pid;
+  worker.m_parameters = parameters;
+  worker.m_startTime = std::chrono::steady_clock::now();
+  worker.m_terminatedEarly = false;
+  worker.m_attempt = attempt;
+  worker.m_failure.clear();
+  worker.m_stalled = false;
+  worker.m_outSize = 0;
+  worker.m_lastGrowth = worker.m_startTime;
+  worker.m_monitor.reset();
+  if (OtherSimulationSettings::earlyTerminationWindow() > 0)
+    worker.m_monitor = std::make_unique<OutcomeMonitor>(
+        worker.m_scratchDirectory + parameters.filename() + ".out",
+        InitHeaderData::m_fixedHeaderParams->m_numberOfBodies,
+        OtherSimulationSettings::earlyTerminationWindow());
+  ++m_running;
+}
+
+// Collects and monitors the integrators without waiting for any to exit
+bool IntegratorScheduler::poll() {
+  if (!m_keepRunning()) {
+    terminateAll();
+    return false;
+  }
+  while (m_running > 0 && reap())
+    ;
+  monitorWorkers();
+  launchRetries();
+  return true;
+}
+
+bool IntegratorScheduler::waitForAll() {
+  for (launchRetries(); m_running > 0; launchRetries())
+    if (!waitForWorker())
+      return false;
+  return true;
+}
+
+bool IntegratorScheduler::waitForWorker() {
+  while (!reap()) {
+    if (!m_keepRunning()) {
+      terminateAll();
+      return false;
+    }
+    monitorWorkers();
+    std::this_thread::sleep_for(POLL_INTERVAL);
+  }
+  return true;
+}
+
+// An integrator stopped early which ignores SIGTERM is killed once the
+// termination timeout has passed, so that it cannot hold its worker forever
+void IntegratorScheduler::monitorWorkers() {
+  auto const now = std::chrono::steady_clock::now();
+  for (auto &worker : m_workers) {
+    if (worker.m_pid <= 0 || !worker.m_failure.empty())
+      continue;
+
+    if (worker.m_terminatedEarly) {
+      if (now >= worker.m_killTime) {
+        signalIntegrator(worker.m_pid, SIGKILL);
+        worker.m_killTime = std::chrono::steady_clock::time_point::max();
+      }
+    } else if (worker.m_monitor && worker.m_monitor->isDecided()) {
+      signalIntegrator(worker.m_pid, SIGTERM);
+      worker.m_terminatedEarly = true;
+      worker.m_killTime = now + TERMINATION_TIMEOUT;
+    } else {
+      enforceLimits(worker);
+    }
+  }
+}
+
+void IntegratorScheduler::enforceLimits(Worker &worker) {
+  auto const wallTimeLimit = OtherSimulationSettings::m_wallTimeLimit;
+  auto const stallTimeLimit = OtherSimulationSettings::m_stallTimeLimit;
+
+  if (stallTimeLimit > 0) {
+    struct stat outStatus;
+    auto const outFilename =
+        worker.m_scratchDirectory + worker.m_parameters.filename() + ".out";
+    if (stat(outFilename.c_str(), &outStatus) == 0 &&
+        outStatus.st_size > worker.m_outSize) {
+      worker.m_outSize = outStatus.st_size;
+      worker.m_lastGrowth = std::chrono::steady_clock::now();
+    }
+  }
+
+  if (wallTimeLimit > 0 &&
+      secondsSince(worker.m_startTime) > static_cast<double>(wallTimeLimit))
+    worker.m_failure = "exceeded its wall-clock limit";
+  else if (stallTimeLimit > 0 && secondsSince(worker.m_lastGrowth) >
+                                     static_cast<double>(stallTimeLimit)) {
+    worker.m_failure = "stopped writing its .out file";
+    worker.m_stalled = true;
+  }
+
+  if (!worker.m_failure.empty())
+    signalIntegrator(worker.m_pid, SIGKILL);
+}
+
+// Asks the integrators to exit, and kills any still running once the
+// termination timeout has passed
+void IntegratorScheduler::terminateAll() {
+  m_retries.clear();
+  for (auto const &worker : m_workers)
+    if (worker.m_pid > 0)
+      signalIntegrator(worker.m_pid, SIGTERM);
+
+  int status;
+  auto const deadline = std::chrono::steady_clock::now() + TERMINATION_TIMEOUT;
+  while (m_running > 0 && std::chrono::steady_clock::now() < deadline) {
+    for (auto &worker : m_workers)
+      if (worker.m_pid > 0 && waitForExit(worker, WNOHANG, status))
+        discard(worker);
+    if (m_running > 0)
+      std::this_thread::sleep_for(POLL_INTERVAL);
+  }
+
+  for (auto &worker : m_workers) {
+    if (worker.m_pid > 0) {
+      signalIntegrator(worker.m_pid, SIGKILL);
+      waitForExit(worker, 0, status);
+      discard(worker);
+    }
+  }
+}
+
+// Only the integrators started by this scheduler are waited for, so that the
+// children of the rest of the process are left to their owners
+bool IntegratorScheduler::reap() {
+  for (auto &worker : m_workers) {
+    if (worker.m_pid <= 0)
+      continue;
+
+    int status;
+    if (waitForExit(worker, WNOHANG, status)) {
+      complete(worker, status);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool IntegratorScheduler::waitForExit(Worker &worker, int options,
+                                      int &status) {
+  for (;;) {
+    auto const pid = waitpid(worker.m_pid, &status, options);
+    if (pid == worker.m_pid)
+      return true;
+    if (pid == 0)
+      return false;
+    if (errno == EINTR)
+      continue;
+    // A process collected by another waiter has exited with an unknown status
+    if (errno == ECHILD && worker.m_failure.empty()) {
+      worker.m_failure = "could not be waited for";
+      status = 0;
+      return true;
+    }
+    throw std::runtime_error(systemError("Failed to wait for an integrator"));
+  }
+}
+
+void IntegratorScheduler::discard(Worker &worker) {
+  worker.m_pid = -1;
+  worker.m_monitor.reset();
+  --m_running;
+}
+
+void IntegratorScheduler::complete(Worker &worker, int status) {
+  worker.m_pid = -1;
+  --m_running;
+
+  auto const filename = worker.m_parameters.filename();
+  auto const outFilename = worker.m_scratchDirectory + filename + ".out";
+  auto const failure = failureReason(worker, status);
+  if (worker.m_terminatedEarly)
+    worker.m_monitor->truncateToCompleteRows();
+  worker.m_monitor.reset();
+
+  if (!failure.empty() && isIntegrationFailure(worker, status) &&
+      worker.m_attempt < OtherSimulationSettings::m_maximumRetries &&
+      m_keepRunning()) {
+    Logger::getInstance().addLog(
+        LogType::Warning, "The integrator for " + filename + " " + failure +
+                              ". Retrying with a shorter time step.");
+    unlink(outFilename.c_str());
+    m_retries.push_back(Retry{worker.m_parameters, worker.m_attempt + 1});
+    return;
+  }
+
+  m_completionHandler(worker.m_parameters, outFilename, failure,
+                      secondsSince(worker.m_startTime));
+}
+
+std::string IntegratorScheduler::failureReason(Worker const &worker,
+                                               int status) const {
+  if (worker.m_terminatedEarly)
+    return std::string();
+  if (!worker.m_failure.empty())
+    return worker.m_failure;
+  if (WIFSIGNALED(status) && WTERMSIG(status) == SIGXCPU)
+    return "exceeded its CPU time limit";
+  if (!m_launcher.empty() && WIFEXITED(status) &&
+      WEXITSTATUS(status) == LIMIT_FAILURE)
+    return "could not have its resource limits set";
+  if (WIFSIGNALED(status))
+    return "was killed by signal " + std::to_string(WTERMSIG(status));
+  if (WEXITSTATUS(status) != 0)
+    return "exited with status " + std::to_string(WEXITSTATUS(status));
+  return std::string();
+}
+
+// Only runs which fail while integrating are retried. A run which overran its
+// wall-clock or CPU time limit would take longer still with a shorter time
+// step, and a run whose limits could not be set would fail the same way again.
+bool IntegratorScheduler::isIntegrationFailure(Worker const &worker,
+                                               int status) const {
+  if (!worker.m_failure.empty())
+    return worker.m_stalled;
+  if (WIFSIGNALED(status))
+    return WTERMSIG(status) != SIGXCPU && WTERMSIG(status) != SIGKILL;
+  return m_launcher.empty() || WEXITSTATUS(status) != LIMIT_FAILURE;
+}
+
+#endif /* __linux__ */
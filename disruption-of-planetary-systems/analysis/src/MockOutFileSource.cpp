@@ -0,0 +1,73 @@
+#include "MockOutFileSource.h"
+#include "Body.h"
+#include "BodyCreator.h"
+#include "InitFileSerializer.h"
+#include "XYZComponents.h"
+
+#include <chrono>
+#include <fstream>
+#include <initializer_list>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+using namespace InitFileSerializer;
+
+// Rows are written to the file in blocks of about this many bytes
+std::size_t constexpr WRITE_BLOCK_SIZE = 1 << 16;
+
+void appendValues(std::string &row, std::initializer_list<double> values) {
+  for (auto const value : values) {
+    row += ' ';
+    appendNumber(row, value);
+  }
+}
+
+} // namespace
+
+MockOutFileSource::MockOutFileSource()
+    : m_numberOfTimeSteps(OtherSimulationSettings::m_mockTimeSteps),
+      m_latency(OtherSimulationSettings::m_mockLatency) {}
+
+MockOutFileSource::~MockOutFileSource() {}
+
+void MockOutFileSource::writeOutFile(InitSimulationParams const &parameters,
+                                     std::string const &outFilename) const {
+  std::this_thread::sleep_for(std::chrono::milliseconds(m_latency));
+
+  auto const planetDistance = parameters.largestPlanetDistance();
+  auto const timeStep =
+      InitHeaderData::timeStep(parameters.m_pericentre, planetDistance);
+  auto const numberOfTimeSteps =
+      m_numberOfTimeSteps > 0
+          ? m_numberOfTimeSteps
+          : InitHeaderData::numberOfTimeStep(parameters.m_pericentre,
+                                             planetDistance);
+  auto const bodies = BodyCreator::createBodies(parameters);
+
+  std::ofstream fileStream(outFilename, std::ios::binary);
+  std::string rows;
+  for (auto step = 0u; step <= numberOfTimeSteps; ++step) {
+    auto const time = static_cast<double>(step) * timeStep;
+    appendNumber(rows, time);
+    for (auto const &body : bodies) {
+      auto const position = body->position(0);
+      auto const velocity = body->velocity(0);
+      appendValues(rows,
+                   {body->mass(), position.compX() + velocity.compX() * time,
+                    position.compY() + velocity.compY() * time,
+                    position.compZ() + velocity.compZ() * time,
+                    velocity.compX(), velocity.compY(), velocity.compZ()});
+    }
+    rows += '\n';
+
+    if (rows.size() >= WRITE_BLOCK_SIZE) {
+      fileStream << rows;
+      rows.clear();
+    }
+  }
+
+  if (!(fileStream << rows))
+    throw std::runtime_error("could not write its mock .out file");
+}
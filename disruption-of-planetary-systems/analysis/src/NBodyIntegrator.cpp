@@ -0,0 +1,214 @@
+#include "NBodyIntegrator.h"
+
+#include "Body.h"
+#include "SimulationConstants.h"
+#include "XYZComponents.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+using namespace SimulationConstants;
+
+// The number of values describing the state of a body
+std::size_t constexpr STATE_SIZE = 6;
+
+// The fraction of the shortest two body dynamical time used as a first step
+double constexpr INITIAL_STEP_FRACTION = 1e-3;
+// Steps shorter than this fraction of the output interval are a failure
+double constexpr MINIMUM_STEP_FRACTION = 1e-12;
+
+// The Dormand-Prince 5(4) tableau, the last row of which gives the solution
+double constexpr A[7][6] = {
+    {},
+    {1.0 / 5.0},
+    {3.0 / 40.0, 9.0 / 40.0},
+    {44.0 / 45.0, -56.0 / 15.0, 32.0 / 9.0},
+    {19372.0 / 6561.0, -25360.0 / 2187.0, 64448.0 / 6561.0, -212.0 / 729.0},
+    {9017.0 / 3168.0, -355.0 / 33.0, 46732.0 / 5247.0, 49.0 / 176.0,
+     -5103.0 / 18656.0},
+    {35.0 / 384.0, 0.0, 500.0 / 1113.0, 125.0 / 192.0, -2187.0 / 6784.0,
+     11.0 / 84.0}};
+// The difference between the fifth and fourth order solutions
+double constexpr E[7] = {71.0 / 57600.0,   0.0,           -71.0 / 16695.0,
+                         71.0 / 1920.0,    -17253.0 / 339200.0,
+                         22.0 / 525.0,     -1.0 / 40.0};
+
+/*
+Takes Dormand-Prince steps of a system of point masses. The derivative at the
+end of an accepted step is reused as the first stage of the next step.
+*/
+class DormandPrinceStepper {
+public:
+  DormandPrinceStepper(std::vector<double> const &masses, double tolerance)
+      : m_masses(masses), m_tolerance(tolerance) {
+    for (auto &stage : m_stages)
+      stage.resize(m_masses.size() * STATE_SIZE);
+    m_stageState.resize(m_masses.size() * STATE_SIZE);
+  }
+
+  void initialise(std::vector<double> const &state) {
+    derivatives(state, m_stages[0]);
+  }
+
+  double attempt(std::vector<double> const &state, double stepSize,
+                 std::vector<double> &nextState) {
+    for (auto stage = 1u; stage < m_stages.size(); ++stage) {
+      auto &target = stage + 1 == m_stages.size() ? nextState : m_stageState;
+      for (auto i = 0u; i < state.size(); ++i) {
+        auto increment = 0.0;
+        for (auto j = 0u; j < stage; ++j)
+          increment += A[stage][j] * m_stages[j][i];
+        target[i] = state[i] + stepSize * increment;
+      }
+      derivatives(target, m_stages[stage]);
+    }
+    return errorNorm(state, nextState, stepSize);
+  }
+
+  void accept() { std::swap(m_stages.front(), m_stages.back()); }
+
+  double initialStepSize(std::vector<double> const &state) const {
+    auto shortestTime = std::numeric_limits<double>::max();
+    for (auto i = 0u; i < m_masses.size(); ++i) {
+      for (auto j = i + 1; j < m_masses.size(); ++j) {
+        auto const r = separation(state, i, j);
+        shortestTime =
+            std::min(shortestTime,
+                     std::sqrt(r * r * r / (G * (m_masses[i] + m_masses[j]))));
+      }
+    }
+    return INITIAL_STEP_FRACTION * shortestTime;
+  }
+
+private:
+  void derivatives(std::vector<double> const &state,
+                   std::vector<double> &derivative) const {
+    for (auto i = 0u; i < m_masses.size(); ++i) {
+      auto const offset = i * STATE_SIZE;
+      for (auto axis = 0u; axis < 3; ++axis) {
+        derivative[offset + axis] = state[offset + 3 + axis];
+        derivative[offset + 3 + axis] = 0.0;
+      }
+    }
+
+    for (auto i = 0u; i < m_masses.size(); ++i) {
+      for (auto j = i + 1; j < m_masses.size(); ++j) {
+        auto const r = separation(state, i, j);
+        auto const factor = G / (r * r * r);
+        for (auto axis = 0u; axis < 3; ++axis) {
+          auto const d =
+              state[j * STATE_SIZE + axis] - state[i * STATE_SIZE + axis];
+          derivative[i * STATE_SIZE + 3 + axis] += factor * m_masses[j] * d;
+          derivative[j * STATE_SIZE + 3 + axis] -= factor * m_masses[i] * d;
+        }
+      }
+    }
+  }
+
+  double errorNorm(std::vector<double> const &state,
+                   std::vector<double> const &nextState,
+                   double stepSize) const {
+    auto sum = 0.0;
+    for (auto i = 0u; i < state.size(); ++i) {
+      auto error = 0.0;
+      for (auto stage = 0u; stage < m_stages.size(); ++stage)
+        error += E[stage] * m_stages[stage][i];
+      auto const scale =
+          m_tolerance *
+          (1.0 + std::max(std::abs(state[i]), std::abs(nextState[i])));
+      sum += std::pow(stepSize * error / scale, 2);
+    }
+    return std::sqrt(sum / static_cast<double>(state.size()));
+  }
+
+  double separation(std::vector<double> const &state, std::size_t i,
+                    std::size_t j) const {
+    auto sum = 0.0;
+    for (auto axis = 0u; axis < 3; ++axis)
+      sum += std::pow(state[j * STATE_SIZE + axis] -
+                          state[i * STATE_SIZE + axis],
+                      2);
+    return std::sqrt(sum);
+  }
+
+  std::vector<double> m_masses;
+  double m_tolerance;
+  std::array<std::vector<double>, 7> m_stages;
+  std::vector<double> m_stageState;
+};
+
+double nextStepSize(double stepSize, double errorNorm) {
+  if (errorNorm == 0.0)
+    return 5.0 * stepSize;
+  return stepSize *
+         std::min(5.0, std::max(0.2, 0.9 * std::pow(errorNorm, -0.2)));
+}
+
+} // namespace
+
+NBodyIntegrator::NBodyIntegrator(double tolerance) : m_tolerance(tolerance) {}
+
+NBodyIntegrator::~NBodyIntegrator() {}
+
+std::vector<std::unique_ptr<Body>> NBodyIntegrator::integrate(
+    std::vector<std::unique_ptr<Body const>> const &bodies, double timeStep,
+    std::size_t numberOfTimeSteps) const {
+  std::vector<double> masses;
+  std::vector<double> state;
+  for (auto const &body : bodies) {
+    masses.emplace_back(body->mass());
+    auto const position = body->position(0);
+    auto const velocity = body->velocity(0);
+    state.insert(state.end(),
+                 {position.compX(), position.compY(), position.compZ(),
+                  velocity.compX(), velocity.compY(), velocity.compZ()});
+  }
+
+  std::vector<Trajectory> trajectories(bodies.size());
+  auto const recordState = [&]() {
+    for (auto i = 0u; i < bodies.size(); ++i)
+      trajectories[i].append(state.data() + i * STATE_SIZE);
+  };
+  for (auto &trajectory : trajectories)
+    trajectory.reserve(numberOfTimeSteps + 1);
+  recordState();
+
+  DormandPrinceStepper stepper(masses, m_tolerance);
+  stepper.initialise(state);
+
+  std::vector<double> nextState(state.size());
+  auto stepSize = std::min(timeStep, stepper.initialStepSize(state));
+  auto time = 0.0;
+  for (auto output = 1u; output <= numberOfTimeSteps; ++output) {
+    auto const outputTime = static_cast<double>(output) * timeStep;
+    while (time < outputTime) {
+      auto const landsOnOutput = time + stepSize >= outputTime;
+      auto const currentStep = landsOnOutput ? outputTime - time : stepSize;
+
+      auto const errorNorm = stepper.attempt(state, currentStep, nextState);
+      if (errorNorm <= 1.0) {
+        time = landsOnOutput ? outputTime : time + currentStep;
+        state.swap(nextState);
+        stepper.accept();
+      }
+
+      stepSize = nextStepSize(currentStep, errorNorm);
+      if (stepSize < MINIMUM_STEP_FRACTION * timeStep)
+        throw std::runtime_error(
+            "The built-in integrator could not resolve a close encounter.");
+    }
+    recordState();
+  }
+
+  std::vector<std::unique_ptr<Body>> integratedBodies;
+  integratedBodies.reserve(bodies.size());
+  for (auto i = 0u; i < bodies.size(); ++i)
+    integratedBodies.emplace_back(
+        std::make_unique<Body>(masses[i], std::move(trajectories[i])));
+  return integratedBodies;
+}
@@ -0,0 +1,131 @@
+#include "OutFileParser.h"
+#include "Body.h"
+#include "SimulationConstants.h"
+#include "Trajectory.h"
+
+#include <algorithm>
+#include <charconv>
+
+namespace {
+
+using namespace SimulationConstants;
+
+// The position and velocity components read for each body in a row
+std::size_t constexpr VALUES_PER_BODY = 6;
+
+bool isSpace(char character) {
+  return character == ' ' || character == '\n' || character == '\t' ||
+         character == '\r' || character == '\v' || character == '\f';
+}
+
+/*
+Walks the whitespace separated columns of the text, converting only the
+columns it is asked to read.
+*/
+class ColumnScanner {
+public:
+  ColumnScanner(char const *begin, char const *end)
+      : m_position(begin), m_end(end) {}
+
+  bool skip() {
+    skipSpace();
+    if (m_position == m_end)
+      return false;
+    while (m_position != m_end && !isSpace(*m_position))
+      ++m_position;
+    return true;
+  }
+
+  bool read(double &value) {
+    skipSpace();
+    // std::from_chars does not accept the sign a stream would
+    if (m_position != m_end && *m_position == '+')
+      ++m_position;
+    auto const result = std::from_chars(m_position, m_end, value);
+    if (result.ec != std::errc() ||
+        (result.ptr != m_end && !isSpace(*result.ptr)))
+      return false;
+    m_position = result.ptr;
+    return true;
+  }
+
+private:
+  void skipSpace() {
+    while (m_position != m_end && isSpace(*m_position))
+      ++m_position;
+  }
+
+  char const *m_position;
+  char const *m_end;
+};
+
+// Estimates the number of rows from the length of the first
+std::size_t estimateNumberOfRows(char const *begin, char const *end) {
+  auto const firstRowEnd = std::find(begin, end, '\n');
+  auto const rowLength = static_cast<std::size_t>(firstRowEnd - begin) + 1;
+  return static_cast<std::size_t>(end - begin) / rowLength + 1;
+}
+
+// Calls the handler with the state of the bodies in each complete row
+template <typename Handler>
+void forEachState(char const *begin, char const *end,
+                  std::size_t numberOfBodies, Handler const &handler) {
+  ColumnScanner scanner(begin, end);
+  std::vector<double> state(numberOfBodies * VALUES_PER_BODY);
+  auto const readRow = [&]() {
+    if (!scanner.skip())
+      return false;
+    for (auto body = state.begin(); body != state.end();
+         body += VALUES_PER_BODY) {
+      if (!scanner.skip())
+        return false;
+      for (auto value = body; value != body + VALUES_PER_BODY; ++value)
+        if (!scanner.read(*value))
+          return false;
+    }
+    return true;
+  };
+
+  while (readRow())
+    handler(state.data());
+}
+
+double bodyMass(std::size_t bodyIndex) {
+  if (bodyIndex == 0)
+    return BH_MASS;
+  return bodyIndex == 1 ? STAR_MASS : PLANET_MASS;
+}
+
+} // namespace
+
+namespace OutFileParser {
+
+std::vector<std::unique_ptr<Body>> parseBodies(char const *begin,
+                                               char const *end,
+                                               std::size_t numberOfBodies) {
+  std::vector<Trajectory> trajectories(numberOfBodies);
+  if (begin != end) {
+    auto const numberOfRows = estimateNumberOfRows(begin, end);
+    for (auto &trajectory : trajectories)
+      trajectory.reserve(numberOfRows);
+  }
+
+  forEachState(begin, end, numberOfBodies, [&](double const *state) {
+    for (auto i = 0u; i < numberOfBodies; ++i)
+      trajectories[i].append(state + i * VALUES_PER_BODY);
+  });
+
+  std::vector<std::unique_ptr<Body>> bodies;
+  bodies.reserve(numberOfBodies);
+  for (auto i = 0u; i < numberOfBodies; ++i)
+    bodies.emplace_back(
+        std::make_unique<Body>(bodyMass(i), std::move(trajectories[i])));
+  return bodies;
+}
+
+void parseStates(char const *begin, char const *end,
+                 std::size_t numberOfBodies, StateHandler const &handler) {
+  forEachState(begin, end, numberOfBodies, handler);
+}
+
+} // namespace OutFileParser
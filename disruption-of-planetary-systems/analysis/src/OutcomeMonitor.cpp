@@ -0,0 +1,104 @@
+#include "OutcomeMonitor.h"
+#include "EnergyKernels.h"
+#include "OutFileParser.h"
+#include "SimulationConstants.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+using namespace SimulationConstants;
+
+namespace {
+
+// The position and velocity components of a body in a state
+std::size_t constexpr VALUES_PER_BODY = 6;
+
+enum Classification { Unbound, BlackHole, Star };
+
+// The same energy as the analysis of the finished .out file, so that both
+// classify a planet alike
+double totalEnergy(double const *target, double const *other,
+                   double targetMass, double otherMass) {
+  return EnergyKernels::totalEnergy(
+      target[0] - other[0], target[1] - other[1], target[2] - other[2],
+      target[3] - other[3], target[4] - other[4], target[5] - other[5],
+      targetMass, otherMass);
+}
+
+} // namespace
+
+OutcomeMonitor::OutcomeMonitor(std::string const &outFilename,
+                               std::size_t numberOfBodies,
+                               std::size_t stableWindow)
+    : m_outFilename(outFilename), m_numberOfBodies(numberOfBodies),
+      m_stableWindow(stableWindow), m_completeLength(0),
+      m_starTrackers(numberOfBodies - 2),
+      m_blackHoleTrackers(numberOfBodies - 2), m_stableRows(0) {}
+
+OutcomeMonitor::~OutcomeMonitor() {}
+
+bool OutcomeMonitor::isDecided() {
+  readRows();
+  return !m_classifications.empty() && m_stableRows >= m_stableWindow;
+}
+
+void OutcomeMonitor::truncateToCompleteRows() const {
+  // A terminated integrator may leave part of a row behind
+  std::error_code error;
+  std::filesystem::resize_file(m_outFilename, m_completeLength, error);
+}
+
+void OutcomeMonitor::readRows() {
+  std::ifstream fileStream(m_outFilename, std::ios::binary);
+  if (!fileStream.is_open() ||
+      !fileStream.seekg(static_cast<std::streamoff>(m_completeLength)))
+    return;
+
+  std::string const text((std::istreambuf_iterator<char>(fileStream)),
+                         std::istreambuf_iterator<char>());
+  // Only the rows ended by a newline have been written in full
+  auto const rowsEnd = text.rfind('\n');
+  if (rowsEnd == std::string::npos)
+    return;
+
+  OutFileParser::parseStates(
+      text.data(), text.data() + rowsEnd + 1, m_numberOfBodies,
+      [this](double const *state) { addState(state); });
+  m_completeLength += rowsEnd + 1;
+}
+
+void OutcomeMonitor::addState(double const *state) {
+  // The black hole is followed by the star and the planets
+  auto const blackHole = state;
+  auto const star = blackHole + VALUES_PER_BODY;
+  for (auto i = 0u; i < m_starTrackers.size(); ++i) {
+    auto const planet = star + VALUES_PER_BODY * (i + 1);
+    m_starTrackers[i].addEnergy(
+        totalEnergy(planet, star, PLANET_MASS, STAR_MASS));
+    m_blackHoleTrackers[i].addEnergy(
+        totalEnergy(planet, blackHole, PLANET_MASS, BH_MASS));
+  }
+
+  auto rowClassifications = classifications();
+  if (rowClassifications == m_classifications) {
+    ++m_stableRows;
+  } else {
+    m_classifications = std::move(rowClassifications);
+    m_stableRows = 0;
+  }
+}
+
+std::vector<int> OutcomeMonitor::classifications() const {
+  std::vector<int> planetClassifications;
+  for (auto i = 0u; i < m_starTrackers.size(); ++i) {
+    if (m_starTrackers[i].isBound())
+      planetClassifications.emplace_back(Classification::Star);
+    else if (m_blackHoleTrackers[i].isBound())
+      planetClassifications.emplace_back(Classification::BlackHole);
+    else
+      planetClassifications.emplace_back(Classification::Unbound);
+  }
+  return planetClassifications;
+}
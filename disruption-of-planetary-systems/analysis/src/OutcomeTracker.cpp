@@ -0,0 +1,176 @@
+#include "OutcomeTracker.h"
+#include "Body.h"
+#include "EnergyKernels.h"
+#include "SimulationConstants.h"
+#include "Trajectory.h"
+#include "XYZComponents.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+using namespace SimulationConstants;
+
+namespace {
+
+// The position and velocity components of a body in a state
+std::size_t constexpr VALUES_PER_BODY = 6;
+// The number of time steps of every body read at a time, small enough for a
+// block of four trajectories to stay in the first level cache
+std::size_t constexpr ENERGY_BLOCK_SIZE = 128;
+
+XYZComponents position(double const *body) {
+  return XYZComponents(body[0], body[1], body[2]);
+}
+
+XYZComponents velocity(double const *body) {
+  return XYZComponents(body[3], body[4], body[5]);
+}
+
+double totalEnergy(double const *target, double const *other,
+                   double targetMass, double otherMass) {
+  return EnergyKernels::totalEnergy(
+      target[0] - other[0], target[1] - other[1], target[2] - other[2],
+      target[3] - other[3], target[4] - other[4], target[5] - other[5],
+      targetMass, otherMass);
+}
+
+// Adds the energies of a block of time steps of a trajectory relative to
+// another
+void addBlockEnergies(BoundEnergyTracker &tracker, Trajectory const &target,
+                      Trajectory const &other, std::size_t first,
+                      std::size_t blockSize, double targetMass,
+                      double otherMass, double *energies) {
+  EnergyKernels::totalEnergies(target, other, first, blockSize, targetMass,
+                               otherMass, energies);
+  for (auto i = 0u; i < blockSize; ++i)
+    tracker.addEnergy(energies[i]);
+}
+
+double semiMajorAxis(XYZComponents const &relativePosition,
+                     XYZComponents const &relativeVelocity, double totalMass) {
+  auto const r = relativePosition.magnitude();
+  auto const v = relativeVelocity.magnitude();
+  return pow(2.0 / r - (pow(v, 2) / (G * totalMass)), -1);
+}
+
+double eccentricity(XYZComponents const &relativePosition,
+                    XYZComponents const &relativeVelocity, double totalMass,
+                    double semiMajorAxis) {
+  auto const h = relativePosition.crossProduct(relativeVelocity).magnitude();
+  return sqrt(1.0 - pow(h, 2) / (G * totalMass * semiMajorAxis));
+}
+
+// The semi-major axis and eccentricity of a bound planet, otherwise zeros. The
+// relative position and velocity are shared by both elements
+std::pair<double, double> orbitalProperties(double const *body,
+                                            double const *planet,
+                                            double bodyMass, bool bound) {
+  if (!bound)
+    return std::make_pair(0.0, 0.0);
+  auto const totalMass = bodyMass + PLANET_MASS;
+  auto const relativePosition = position(body) - position(planet);
+  auto const relativeVelocity = velocity(body) - velocity(planet);
+  auto const axis =
+      semiMajorAxis(relativePosition, relativeVelocity, totalMass);
+  return std::make_pair(axis, eccentricity(relativePosition, relativeVelocity,
+                                           totalMass, axis));
+}
+
+} // namespace
+
+OutcomeTracker::OutcomeTracker(std::size_t numberOfBodies)
+    : m_numberOfBodies(numberOfBodies),
+      m_lastState(numberOfBodies * VALUES_PER_BODY), m_hasState(false),
+      m_starTrackers(numberOfBodies - 2),
+      m_blackHoleTrackers(numberOfBodies - 2) {}
+
+OutcomeTracker::~OutcomeTracker() {}
+
+void OutcomeTracker::addState(double const *state) {
+  // The energies of a state are only counted once it is not the last
+  if (m_hasState)
+    addEnergies();
+  std::copy(state, state + m_lastState.size(), m_lastState.begin());
+  m_hasState = true;
+}
+
+void OutcomeTracker::addTrajectories(
+    std::vector<std::unique_ptr<Body>> const &bodies) {
+  auto const numberOfTimeSteps = bodies.front()->numberOfTimeSteps();
+  if (numberOfTimeSteps == 0)
+    return;
+  if (m_hasState)
+    addEnergies();
+
+  // Every time step but the last is checked by the energy criteria. The
+  // trajectories are swept once, with the energies of every planet relative
+  // to the star and the black hole computed from each block while it is cached
+  auto const &blackHole = bodies[0]->trajectory();
+  auto const &star = bodies[1]->trajectory();
+  auto const numberOfEnergies = numberOfTimeSteps - 1;
+  alignas(Trajectory::ALIGNMENT) std::array<double, ENERGY_BLOCK_SIZE> energies;
+  for (std::size_t first = 0; first < numberOfEnergies;
+       first += ENERGY_BLOCK_SIZE) {
+    auto const blockSize =
+        std::min(ENERGY_BLOCK_SIZE, numberOfEnergies - first);
+    for (auto i = 0u; i < m_starTrackers.size(); ++i) {
+      auto const &planet = bodies[i + 2]->trajectory();
+      addBlockEnergies(m_starTrackers[i], planet, star, first, blockSize,
+                       PLANET_MASS, STAR_MASS, energies.data());
+      addBlockEnergies(m_blackHoleTrackers[i], planet, blackHole, first,
+                       blockSize, PLANET_MASS, BH_MASS, energies.data());
+    }
+  }
+
+  auto const lastStep = numberOfTimeSteps - 1;
+  auto state = m_lastState.begin();
+  for (auto i = 0u; i < m_numberOfBodies; ++i) {
+    auto const &trajectory = bodies[i]->trajectory();
+    for (auto const &component :
+         {trajectory.x(), trajectory.y(), trajectory.z(), trajectory.vx(),
+          trajectory.vy(), trajectory.vz()})
+      *state++ = component[lastStep];
+  }
+  m_hasState = true;
+}
+
+void OutcomeTracker::addEnergies() {
+  auto const blackHole = m_lastState.data();
+  auto const star = blackHole + VALUES_PER_BODY;
+  for (auto i = 0u; i < m_starTrackers.size(); ++i) {
+    auto const planet = star + VALUES_PER_BODY * (i + 1);
+    m_starTrackers[i].addEnergy(
+        totalEnergy(planet, star, PLANET_MASS, STAR_MASS));
+    m_blackHoleTrackers[i].addEnergy(
+        totalEnergy(planet, blackHole, PLANET_MASS, BH_MASS));
+  }
+}
+
+std::vector<RunOutcome> OutcomeTracker::outcomes() const {
+  if (!m_hasState)
+    throw std::runtime_error("The trajectory has no time steps.");
+
+  auto const blackHole = m_lastState.data();
+  auto const star = blackHole + VALUES_PER_BODY;
+  std::vector<RunOutcome> planetOutcomes;
+  planetOutcomes.reserve(m_starTrackers.size());
+  for (auto i = 0u; i < m_starTrackers.size(); ++i) {
+    auto const planet = star + VALUES_PER_BODY * (i + 1);
+    auto const boundToStar = m_starTrackers[i].isBound();
+    auto const boundToBlackHole =
+        !boundToStar && m_blackHoleTrackers[i].isBound();
+
+    auto const bhOrbitProps =
+        orbitalProperties(blackHole, planet, BH_MASS, boundToBlackHole);
+    auto const starOrbitProps =
+        orbitalProperties(star, planet, STAR_MASS, boundToStar);
+    planetOutcomes.emplace_back(
+        RunOutcome{boundToBlackHole, boundToStar, bhOrbitProps.first,
+                   starOrbitProps.first, bhOrbitProps.second,
+                   starOrbitProps.second});
+  }
+  return planetOutcomes;
+}
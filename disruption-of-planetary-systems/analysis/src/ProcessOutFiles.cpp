@@ -2,59 +2,192 @@
 
 #include "Body.h"
 #include "InitSimulationParams.h"
+#include "OutFileParser.h"
+#include "OutcomeTracker.h"
+#include "RandomStream.h"
+#include "ResultsWriter.h"
 #include "SimulationConstants.h"
+#include "SimulationParamsStream.h"
 #include "SimulationResult.h"
-#include "XYZComponents.h"
+#include "SweepFiles.h"
+#include "SweepJournal.h"
 
-#include "FileManager.h"
+#include "BufferedFileWriter.h"
 #include "Logger.h"
+#include "MappedFile.h"
+#include "PackedFile.h"
 #include "TaskRunner.h"
 #include "ThreadPool.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <limits>
+#include <thread>
 
 using namespace SimulationConstants;
 
-OutFileProcessor::OutFileProcessor(std::string const &directory)
-    : m_mutex(), m_directory(directory),
-      m_taskRunner(TaskRunner::getInstance()) {}
+namespace {
+
+// The number of out files a thread pulls from the stream at a time
+std::size_t constexpr PARAMETERS_PER_CHUNK = 16;
+
+// The black hole and star are followed by one or two planets
+std::size_t numberOfBodies() {
+  return OtherSimulationSettings::m_hasSinglePlanet ? 3 : 4;
+}
+
+// The quantiles of each orbital element written to the results
+std::array<std::pair<double, char const *>, 3> constexpr QUANTILES = {
+    {{0.1, "Q10"}, {0.5, "Median"}, {0.9, "Q90"}}};
+
+char const *const FRACTIONS[] = {"BhBoundFraction", "StarBoundFraction",
+                                 "UnboundFraction"};
+
+// The orientation index keying the bootstrap stream of a cell, beyond those
+// of any run
+std::size_t constexpr BOOTSTRAP_STREAM =
+    std::numeric_limits<std::size_t>::max();
+
+std::size_t numberOfBootstrapThreads() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void addInterval(ResultsWriter &writer, FractionInterval const &interval) {
+  writer.addValue(interval.m_lower);
+  writer.addValue(interval.m_upper);
+}
+
+struct NamedDistribution {
+  char const *m_name;
+  ElementDistribution const &(MutableResult::*m_distribution)() const;
+};
+
+std::array<NamedDistribution, 4> constexpr DISTRIBUTIONS = {
+    {{"SemiMajorBh", &MutableResult::semiMajorBhDistribution},
+     {"SemiMajorStar", &MutableResult::semiMajorStarDistribution},
+     {"EccentricityBh", &MutableResult::eccentricityBhDistribution},
+     {"EccentricityStar", &MutableResult::eccentricityStarDistribution}}};
+
+void writeHistogramEdges(BufferedFileWriter &file, char const *name,
+                         Histogram const &histogram) {
+  file.append('\n');
+  file.append(name);
+  for (auto i = 0u; i <= histogram.numberOfBins(); ++i) {
+    file.append(' ');
+    ResultsWriter::appendFixed(file, histogram.binEdge(i));
+  }
+}
+
+std::vector<RunOutcome> parseOutcomes(char const *begin, char const *end) {
+  OutcomeTracker tracker(numberOfBodies());
+  OutFileParser::parseStates(
+      begin, end, numberOfBodies(),
+      [&tracker](double const *state) { tracker.addState(state); });
+  return tracker.outcomes();
+}
+
+// Identifies each reset of the results of any processor, so that a thread
+// never adds outcomes to the grids of an earlier reset
+std::uint64_t nextResultsGeneration() {
+  static std::atomic<std::uint64_t> generation(0);
+  return ++generation;
+}
+
+} // namespace
+
+OutFileProcessor::OutFileProcessor(std::string const &directory,
+                                   SweepJournal &journal)
+    : m_mutex(), m_directory(directory), m_journal(journal),
+      m_taskRunner(TaskRunner::getInstance()),
+      m_resultsGeneration(nextResultsGeneration()) {}
 
 OutFileProcessor::~OutFileProcessor() {}
 
-void OutFileProcessor::resetProcessor(std::size_t numberOfOutFiles) {
-  m_resultsA.clear();
-  m_resultsB.clear();
+void OutFileProcessor::resetResults(SweepDefinition const &sweep) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_emptyResults.clear();
+  m_emptyResults.emplace_back(sweep.m_pericentreValues,
+                              sweep.m_planetDistanceAValues);
+  if (!OtherSimulationSettings::m_hasSinglePlanet)
+    m_emptyResults.emplace_back(sweep.m_pericentreValues,
+                                sweep.m_planetDistanceBValues);
+  m_threadResults.clear();
+  m_resultsGeneration = nextResultsGeneration();
+  m_outPack.reset();
+}
+
+void OutFileProcessor::resetProcessor(SweepDefinition const &sweep,
+                                      std::size_t numberOfOutFiles) {
+  resetResults(sweep);
+  if (OtherSimulationSettings::m_usePackedFiles)
+    m_outPack =
+        std::make_unique<PackedFileReader>(m_directory + SweepFiles::OUT_PACK);
   m_taskRunner.setTask("Processing out files...", 20.0, 100.0);
   m_taskRunner.setNumberOfSteps(numberOfOutFiles);
 }
 
-bool OutFileProcessor::performAnalysis(
-    std::vector<InitSimulationParams> const &simulationParameters) {
-  resetProcessor(simulationParameters.size());
+bool OutFileProcessor::performAnalysis(SweepDefinition const &sweep) {
+  SimulationParamsStream parametersStream(sweep);
+  resetProcessor(sweep, parametersStream.size());
 
-  processOutFiles(simulationParameters);
+  processOutFiles(parametersStream);
 
   saveResults();
+  if (OtherSimulationSettings::m_deleteOutFiles && m_taskRunner.isRunning())
+    deleteOutFiles();
   return true;
 }
 
 void OutFileProcessor::processOutFiles(
-    std::vector<InitSimulationParams> const &simulationParameters) {
-  ThreadPool pool(5);
+    SimulationParamsStream &parametersStream) {
+  auto const numberOfThreads = 5u;
+  ThreadPool pool(numberOfThreads);
 
-  for (auto const &parameters : simulationParameters) {
+  for (auto i = 0u; i < numberOfThreads; ++i) {
     pool.addToQueue([&]() {
-      if (m_taskRunner.isRunning()) {
-        processOutFile(parameters);
-        m_taskRunner.reportProgress();
-      }
+      std::vector<InitSimulationParams> parameters;
+      while (m_taskRunner.isRunning() &&
+             parametersStream.next(parameters, PARAMETERS_PER_CHUNK))
+        processOutFiles(parameters);
     });
   }
 }
 
+void OutFileProcessor::processOutFiles(
+    std::vector<InitSimulationParams> const &parameters) {
+  for (auto const &simParameters : parameters) {
+    if (m_taskRunner.isRunning()) {
+      if (!restoreOutcomes(simParameters)) {
+        processOutFile(simParameters);
+        if (OtherSimulationSettings::m_deleteOutFiles && !m_outPack)
+          deleteOutFile(simParameters);
+      }
+      m_taskRunner.reportProgress();
+    }
+  }
+}
+
+void OutFileProcessor::deleteOutFiles() {
+  // Out files are deleted one at a time as they are analysed unless packed
+  if (m_outPack) {
+    m_outPack.reset();
+    PackedFile::remove(m_directory + SweepFiles::OUT_PACK);
+  }
+}
+
+void OutFileProcessor::deleteOutFile(
+    InitSimulationParams const &parameters) const {
+  auto const filename = parameters.filename() + ".out";
+  if (std::remove((m_directory + filename).c_str()) != 0)
+    Logger::getInstance().addLog(LogType::Warning,
+                                 "Failed to delete file " + filename + ".");
+}
+
 void OutFileProcessor::processOutFile(InitSimulationParams const &parameters) {
   try {
-    processOutFile(parameters, loadOutFile(parameters));
+    recordOutcomes(parameters, streamOutcomes(parameters));
   } catch (std::runtime_error const &error) {
     m_taskRunner.stopTask();
     Logger::getInstance().addLog(LogType::Error,
@@ -63,327 +196,293 @@ void OutFileProcessor::processOutFile(InitSimulationParams const &parameters) {
   }
 }
 
-void OutFileProcessor::processOutFile(
+void OutFileProcessor::processOutRecord(InitSimulationParams const &parameters,
+                                        std::string const &outRecord) {
+  try {
+    recordOutcomes(parameters, parseOutcomes(outRecord.data(),
+                                             outRecord.data() +
+                                                 outRecord.size()));
+  } catch (std::runtime_error const &error) {
+    m_taskRunner.stopTask();
+    Logger::getInstance().addLog(LogType::Error,
+                                 std::string("Processing out files failed: ") +
+                                     error.what());
+  }
+}
+
+std::vector<RunOutcome> OutFileProcessor::processTrajectory(
     InitSimulationParams const &parameters,
     std::vector<std::unique_ptr<Body>> const &bodies) {
-  if (OtherSimulationSettings::m_hasSinglePlanet)
-    computeSimulationResults(parameters, *bodies[0], *bodies[1], *bodies[2],
-                             parameters.m_planetDistances[0]);
-  else
-    computeSimulationResults4Body(parameters, *bodies[0], *bodies[1],
-                                  *bodies[2], *bodies[3]);
+  auto const outcomes = computeOutcomes(bodies);
+  recordOutcomes(parameters, outcomes);
+  return outcomes;
 }
 
-void OutFileProcessor::computeSimulationResults4Body(
-    InitSimulationParams const &parameters, Body const &blackHole,
-    Body const &star, Body const &planetA, Body const &planetB) {
-  computeSimulationResults(parameters, blackHole, star, planetA,
-                           parameters.m_planetDistances[0], PlanetID::A);
-  computeSimulationResults(parameters, blackHole, star, planetB,
-                           parameters.m_planetDistances[1], PlanetID::B);
+void OutFileProcessor::recordOutcomes(
+    InitSimulationParams const &parameters,
+    std::vector<RunOutcome> const &outcomes) {
+  m_journal.recordAnalysed(parameters, outcomes);
+  addOutcomes(parameters, outcomes);
 }
 
-void OutFileProcessor::computeSimulationResults(
-    InitSimulationParams const &parameters, Body const &blackHole,
-    Body const &star, Body const &planet, double planetDistance,
-    PlanetID const &planetID) {
-  auto const stepIndex = planet.numberOfTimeSteps() - 1;
-
-  auto const boundToStar = isBound(planet, star, stepIndex);
-  bool boundToBlackHole(false);
-  if (!boundToStar)
-    boundToBlackHole = isBound(planet, blackHole, stepIndex);
-
-  auto const bhOrbitProps = calculateOrbitalProperties(
-      blackHole, planet, stepIndex, boundToBlackHole);
-  auto const starOrbitProps =
-      calculateOrbitalProperties(star, planet, stepIndex, boundToStar);
-
-  addResult(parameters.m_pericentre, planetDistance, boundToBlackHole,
-            boundToStar, bhOrbitProps.first, starOrbitProps.first,
-            bhOrbitProps.second, starOrbitProps.second, planetID);
+std::vector<RunOutcome> OutFileProcessor::computeOutcomes(
+    std::vector<std::unique_ptr<Body>> const &bodies) const {
+  OutcomeTracker tracker(bodies.size());
+  tracker.addTrajectories(bodies);
+  return tracker.outcomes();
 }
 
-std::vector<std::unique_ptr<Body>>
-OutFileProcessor::loadOutFile(InitSimulationParams const &parameters) const {
-  std::ifstream fileStream(m_directory + parameters.m_filename + ".out");
-  if (fileStream.is_open())
-    return loadOutFile(fileStream);
-  throw std::runtime_error("The " + parameters.m_filename +
-                           ".out file does not exist.");
+bool OutFileProcessor::restoreOutcomes(
+    InitSimulationParams const &parameters) {
+  auto const state = m_journal.state(parameters);
+  // A failed run has no outcomes to add
+  if (state == RunState::Failed)
+    return true;
+  if (state != RunState::Analysed)
+    return false;
+
+  addOutcomes(parameters, m_journal.outcomes(parameters));
+  return true;
 }
 
-std::vector<std::unique_ptr<Body>>
-OutFileProcessor::loadOutFile(std::ifstream &fileStream) const {
-  if (OtherSimulationSettings::m_hasSinglePlanet)
-    return loadOutFile3Body(fileStream);
-  return loadOutFile4Body(fileStream);
+void OutFileProcessor::addOutcomes(InitSimulationParams const &parameters,
+                                   std::vector<RunOutcome> const &outcomes) {
+  auto &results = threadResults();
+  for (auto i = 0u; i < outcomes.size(); ++i)
+    results.at(i).addOutcome(parameters.m_pericentre,
+                             parameters.m_planetDistances[i],
+                             parameters.m_runId, outcomes[i]);
 }
 
-std::vector<std::unique_ptr<Body>>
-OutFileProcessor::loadOutFile3Body(std::ifstream &fileStream) const {
-  std::vector<XYZComponents> bhPositions, bhVelocities, starPositions,
-      starVelocities, planetPositions, planetVelocities;
-
-  double a, bhMass, bhX, bhY, bhZ, bhVx, bhVy, bhVz, sMass, sX, sY, sZ, sVx,
-      sVy, sVz, pMass, pX, pY, pZ, pVx, pVy, pVz;
-
-  while (fileStream >> a >> bhMass >> bhX >> bhY >> bhZ >> bhVx >> bhVy >>
-         bhVz >> sMass >> sX >> sY >> sZ >> sVx >> sVy >> sVz >> pMass >> pX >>
-         pY >> pZ >> pVx >> pVy >> pVz) {
-    bhPositions.emplace_back(XYZComponents(bhX, bhY, bhZ));
-    bhVelocities.emplace_back(XYZComponents(bhVx, bhVy, bhVz));
-    starPositions.emplace_back(XYZComponents(sX, sY, sZ));
-    starVelocities.emplace_back(XYZComponents(sVx, sVy, sVz));
-    planetPositions.emplace_back(XYZComponents(pX, pY, pZ));
-    planetVelocities.emplace_back(XYZComponents(pVx, pVy, pVz));
+// The grids of the calling thread, created the first time it records outcomes
+// after the results were reset
+std::vector<ResultGrid> &OutFileProcessor::threadResults() {
+  struct ThreadResults {
+    std::uint64_t m_generation;
+    std::vector<ResultGrid> *m_results;
+  };
+  thread_local ThreadResults cached{0, nullptr};
+
+  std::unique_lock<std::mutex> lock(m_mutex, std::defer_lock);
+  if (cached.m_generation != m_resultsGeneration) {
+    lock.lock();
+    m_threadResults.emplace_back(
+        std::make_unique<std::vector<ResultGrid>>(m_emptyResults));
+    cached = ThreadResults{m_resultsGeneration, m_threadResults.back().get()};
   }
+  return *cached.m_results;
+}
 
-  std::vector<std::unique_ptr<Body>> allBodies;
-  allBodies.reserve(3);
-  allBodies.emplace_back(std::make_unique<Body>(BH_MASS, std::move(bhPositions),
-                                                std::move(bhVelocities)));
-  allBodies.emplace_back(std::make_unique<Body>(
-      STAR_MASS, std::move(starPositions), std::move(starVelocities)));
-  allBodies.emplace_back(std::make_unique<Body>(
-      PLANET_MASS, std::move(planetPositions), std::move(planetVelocities)));
-  return std::move(allBodies);
+std::vector<ResultGrid> OutFileProcessor::mergeResults() const {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  auto merged = m_emptyResults;
+  for (auto const &results : m_threadResults)
+    for (auto i = 0u; i < merged.size(); ++i)
+      merged[i].merge((*results)[i]);
+  return merged;
 }
 
-std::vector<std::unique_ptr<Body>>
-OutFileProcessor::loadOutFile4Body(std::ifstream &fileStream) const {
-  std::vector<XYZComponents> bhPositions, bhVelocities, starPositions,
-      starVelocities, planet1Positions, planet1Velocities, planet2Positions,
-      planet2Velocities;
-
-  double a, bhMass, bhX, bhY, bhZ, bhVx, bhVy, bhVz, sMass, sX, sY, sZ, sVx,
-      sVy, sVz, p1Mass, p1X, p1Y, p1Z, p1Vx, p1Vy, p1Vz, p2Mass, p2X, p2Y, p2Z,
-      p2Vx, p2Vy, p2Vz;
-
-  while (fileStream >> a >> bhMass >> bhX >> bhY >> bhZ >> bhVx >> bhVy >>
-         bhVz >> sMass >> sX >> sY >> sZ >> sVx >> sVy >> sVz >> p1Mass >>
-         p1X >> p1Y >> p1Z >> p1Vx >> p1Vy >> p1Vz >> p2Mass >> p2X >> p2Y >>
-         p2Z >> p2Vx >> p2Vy >> p2Vz) {
-    bhPositions.emplace_back(XYZComponents(bhX, bhY, bhZ));
-    bhVelocities.emplace_back(XYZComponents(bhVx, bhVy, bhVz));
-    starPositions.emplace_back(XYZComponents(sX, sY, sZ));
-    starVelocities.emplace_back(XYZComponents(sVx, sVy, sVz));
-    planet1Positions.emplace_back(XYZComponents(p1X, p1Y, p1Z));
-    planet1Velocities.emplace_back(XYZComponents(p1Vx, p1Vy, p1Vz));
-    planet2Positions.emplace_back(XYZComponents(p2X, p2Y, p2Z));
-    planet2Velocities.emplace_back(XYZComponents(p2Vx, p2Vy, p2Vz));
+template <typename Parser>
+auto OutFileProcessor::parseOutFile(InitSimulationParams const &parameters,
+                                    Parser const &parser) const {
+  auto const filename = parameters.filename();
+  if (m_outPack) {
+    auto const record = m_outPack->read(filename);
+    return parser(record.data(), record.data() + record.size());
   }
 
-  std::vector<std::unique_ptr<Body>> allBodies;
-  allBodies.reserve(4);
-  allBodies.emplace_back(std::make_unique<Body>(BH_MASS, std::move(bhPositions),
-                                                std::move(bhVelocities)));
-  allBodies.emplace_back(std::make_unique<Body>(
-      STAR_MASS, std::move(starPositions), std::move(starVelocities)));
-  allBodies.emplace_back(std::make_unique<Body>(
-      PLANET_MASS, std::move(planet1Positions), std::move(planet1Velocities)));
-  allBodies.emplace_back(std::make_unique<Body>(
-      PLANET_MASS, std::move(planet2Positions), std::move(planet2Velocities)));
-  return std::move(allBodies);
+  MappedFile const outFile(m_directory + filename + ".out");
+  if (outFile.isOpen())
+    return parser(outFile.data(), outFile.data() + outFile.size());
+  throw std::runtime_error("The " + filename +
+                           ".out file does not exist.");
 }
 
-std::vector<double> OutFileProcessor::calculateBodyTotalEnergies(
-    Body const &targetBody, Body const &otherBody,
-    std::size_t numberOfTimeSteps) const {
-  std::vector<double> totalEnergies;
-  totalEnergies.reserve(numberOfTimeSteps);
-
-  for (auto i = 0u; i < numberOfTimeSteps; ++i)
-    totalEnergies.emplace_back(calculateTotalEnergy(targetBody, otherBody, i));
-  return std::move(totalEnergies);
+std::vector<std::unique_ptr<Body>>
+OutFileProcessor::loadOutFile(InitSimulationParams const &parameters) const {
+  return parseOutFile(parameters, [](char const *begin, char const *end) {
+    return OutFileParser::parseBodies(begin, end, numberOfBodies());
+  });
 }
 
-double OutFileProcessor::calculateTotalEnergy(Body const &targetBody,
-                                              Body const &otherBody,
-                                              std::size_t index) const {
-  auto const m = targetBody.mass();
-  auto const r = targetBody.relativePositionMagnitude(otherBody, index);
-  auto const v = targetBody.relativeVelocityMagnitude(otherBody, index);
-  return 0.5 * m * pow(v, 2) - G * otherBody.mass() * m / r;
+std::vector<RunOutcome>
+OutFileProcessor::streamOutcomes(InitSimulationParams const &parameters) const {
+  return parseOutFile(parameters, parseOutcomes);
 }
 
-bool OutFileProcessor::isBound(Body const &targetBody, Body const &otherBody,
-                               std::size_t index) const {
-  auto const totalEnergies =
-      calculateBodyTotalEnergies(targetBody, otherBody, index);
-
-  return isBound(totalEnergies);
+void OutFileProcessor::saveResults() const {
+  auto const results = mergeResults();
+  if (OtherSimulationSettings::m_hasSinglePlanet)
+    save3BodyResults(results);
+  else
+    save4BodyResults(results);
 }
 
-bool OutFileProcessor::isBound(std::vector<double> const &energies) const {
-  auto const maxIter = std::max_element(energies.begin(), energies.end());
-  auto const minIter = std::min_element(maxIter, energies.end());
-
-  return std::all_of(minIter, energies.end(), [](double x) { return x < 0.0; });
+void OutFileProcessor::save3BodyResults(
+    std::vector<ResultGrid> const &results) const {
+  saveResults("", results.at(0).results());
 }
 
-double OutFileProcessor::calculateHillsRadius(double pericentre) const {
-  return pericentre * pow(STAR_MASS / (3 * BH_MASS), 1.0 / 3.0);
-}
+void OutFileProcessor::save4BodyResults(
+    std::vector<ResultGrid> const &results) const {
+  saveResults("A", results.at(0).results());
+  saveResults("B", results.at(1).results());
 
-std::pair<double, double> OutFileProcessor::calculateOrbitalProperties(
-    Body const &body1, Body const &body2, std::size_t index, bool bound) const {
-  if (bound) {
-    auto const semiMajorAxis = calculateSemiMajorAxis(body1, body2, index);
-    auto const eccentricity =
-        calculateEccentricity(body1, body2, semiMajorAxis, index);
-    return std::pair<double, double>(std::move(semiMajorAxis),
-                                     std::move(eccentricity));
-  }
-  return std::pair<double, double>(0.0, 0.0);
-}
-
-double OutFileProcessor::calculateSemiMajorAxis(Body const &body1,
-                                                Body const &body2,
-                                                std::size_t index) const {
-  auto const m_total = body1.mass() + body2.mass();
-  auto const r = body1.relativePositionMagnitude(body2, index);
-  auto const v = body1.relativeVelocityMagnitude(body2, index);
-  return pow(2.0 / r - (pow(v, 2) / (G * m_total)), -1);
-}
-
-double OutFileProcessor::calculateEccentricity(Body const &body1,
-                                               Body const &body2,
-                                               double semiMajorAxis,
-                                               std::size_t index) const {
-  auto const m_total = body1.mass() + body2.mass();
-  auto const relativePosition = body1.position(index) - body2.position(index);
-  auto const relativeVelocity = body1.velocity(index) - body2.velocity(index);
-  auto const h = relativePosition.crossProduct(relativeVelocity).magnitude();
-
-  return sqrt(1.0 - pow(h, 2) / (G * m_total * semiMajorAxis));
-}
-
-void OutFileProcessor::addResult(double pericentre, double planetDistance,
-                                 bool bhBound, bool starBound,
-                                 double semiMajorBh, double semiMajorStar,
-                                 double eccentricityBh, double eccentricityStar,
-                                 PlanetID const &planetID) {
-  if (planetID == PlanetID::None || planetID == PlanetID::A) {
-    addResult(m_resultsA, pericentre, planetDistance, bhBound, starBound,
-              semiMajorBh, semiMajorStar, eccentricityBh, eccentricityStar);
-  } else if (planetID == PlanetID::B) {
-    addResult(m_resultsB, pericentre, planetDistance, bhBound, starBound,
-              semiMajorBh, semiMajorStar, eccentricityBh, eccentricityStar);
-  }
+  if (OtherSimulationSettings::m_combinePlanetResults)
+    saveResults("", combineResults(results));
 }
 
-void OutFileProcessor::addResult(
-    std::map<std::pair<double, double>, MutableResult> &results,
-    double pericentre, double planetDistance, bool bhBound, bool starBound,
-    double semiMajorBh, double semiMajorStar, double eccentricityBh,
-    double eccentricityStar) {
-  if (!updateResult(results, pericentre, planetDistance, bhBound, starBound,
-                    semiMajorBh, semiMajorStar, eccentricityBh,
-                    eccentricityStar)) {
-    std::unique_lock<std::mutex> lock(m_mutex);
-    results[std::make_pair(pericentre, planetDistance)] = MutableResult(
-        calculateHillsRadius(pericentre), bhBound, starBound, semiMajorBh,
-        semiMajorStar, eccentricityBh, eccentricityStar);
-  }
+// Saves the results along with the histograms of their orbital elements
+void OutFileProcessor::saveResults(
+    std::string const &suffix,
+    std::map<std::pair<double, double>, MutableResult> const &results) const {
+  writeResults(m_directory + "simulation_results" + suffix +
+                   ResultsWriter::extension(
+                       OtherSimulationSettings::m_resultsFormat),
+               results);
+  writeHistograms(m_directory + "simulation_histograms" + suffix + ".txt",
+                  results);
 }
 
-bool OutFileProcessor::updateResult(
-    std::map<std::pair<double, double>, MutableResult> &results,
-    double pericentre, double planetDistance, bool bhBound, bool starBound,
-    double semiMajorBh, double semiMajorStar, double eccentricityBh,
-    double eccentricityStar) {
-  auto const predicate = [&pericentre, &planetDistance](auto const &result) {
-    return pericentre == result.first.first &&
-           planetDistance == result.first.second;
-  };
-  return updateResult(results, pericentre, planetDistance, bhBound, starBound,
-                      semiMajorBh, semiMajorStar, eccentricityBh,
-                      eccentricityStar, predicate);
+std::map<std::pair<double, double>, MutableResult>
+OutFileProcessor::combineResults(std::vector<ResultGrid> const &results) const {
+  auto combinedResults = results.at(0).results();
+  auto const resultsB = results.at(1).results();
+  combinedResults.insert(resultsB.begin(), resultsB.end());
+  return combinedResults;
 }
 
-template <typename Predicate>
-bool OutFileProcessor::updateResult(
-    std::map<std::pair<double, double>, MutableResult> &results,
-    double pericentre, double planetDistance, bool bhBound, bool starBound,
-    double semiMajorBh, double semiMajorStar, double eccentricityBh,
-    double eccentricityStar, Predicate const &predicate) {
-  std::unique_lock<std::mutex> lock(m_mutex);
-
-  auto const iter = std::find_if(results.begin(), results.end(), predicate);
-  if (iter != results.end()) {
-    results[std::make_pair(pericentre, planetDistance)] =
-        iter->second + MutableResult(calculateHillsRadius(pericentre), bhBound,
-                                     starBound, semiMajorBh, semiMajorStar,
-                                     eccentricityBh, eccentricityStar);
-    return true;
+std::vector<std::string> OutFileProcessor::resultsColumns() const {
+  std::vector<std::string> columns = {
+      "Pericentre",           "PlanetDistance",        "HillsRadius",
+      "BhBoundFraction",      "StarBoundFraction",     "UnboundFraction",
+      "BhBoundFractionError", "StarBoundFractionError", "UnboundFractionError"};
+  for (auto const fraction : FRACTIONS) {
+    columns.emplace_back(std::string(fraction) + "Lower");
+    columns.emplace_back(std::string(fraction) + "Upper");
   }
-  return false;
+  if (OtherSimulationSettings::m_bootstrapResamples > 0)
+    for (auto const fraction : FRACTIONS) {
+      columns.emplace_back(std::string(fraction) + "BootstrapLower");
+      columns.emplace_back(std::string(fraction) + "BootstrapUpper");
+    }
+  for (auto const &distribution : DISTRIBUTIONS)
+    for (auto const &quantile : QUANTILES)
+      columns.emplace_back(std::string(distribution.m_name) + quantile.second);
+  return columns;
 }
 
-void OutFileProcessor::saveResults() const {
-  if (OtherSimulationSettings::m_hasSinglePlanet)
-    save3BodyResults();
-  else
-    save4BodyResults();
+// The elements themselves are only kept when they are to be written
+std::vector<std::string> OutFileProcessor::resultsListColumns() const {
+  if (OtherSimulationSettings::m_writeOrbitalElements)
+    return {"SemiMajorsBh", "EccentricitiesBh"};
+  return {};
 }
 
-void OutFileProcessor::save3BodyResults() const {
-  saveResults("simulation_results.txt", generateResultsFileText(m_resultsA));
+// Streams each row into the file as it is formatted
+void OutFileProcessor::writeResults(
+    std::string const &filename,
+    std::map<std::pair<double, double>, MutableResult> const &results) const {
+  auto const intervals = bootstrapIntervals(results);
+  ResultsWriter writer(filename, OtherSimulationSettings::m_resultsFormat,
+                       resultsColumns(), resultsListColumns());
+  auto index = 0u;
+  for (auto const &result : results)
+    writeResultRow(writer, result.first, result.second, intervals[index++]);
+  writer.finish();
 }
 
-void OutFileProcessor::save4BodyResults() const {
-  saveResults("simulation_resultsA.txt", generateResultsFileText(m_resultsA));
-  saveResults("simulation_resultsB.txt", generateResultsFileText(m_resultsB));
-
-  if (OtherSimulationSettings::m_combinePlanetResults)
-    saveResults("simulation_results.txt",
-                generateResultsFileText(combineResults()));
+// Resamples the cells in parallel, each from its own random stream so that
+// the intervals do not depend on the number of threads
+std::vector<std::array<FractionInterval, 3>>
+OutFileProcessor::bootstrapIntervals(
+    std::map<std::pair<double, double>, MutableResult> const &results) const {
+  std::vector<std::array<FractionInterval, 3>> intervals(results.size());
+  auto const numberOfResamples = OtherSimulationSettings::m_bootstrapResamples;
+  if (numberOfResamples == 0)
+    return intervals;
+
+  {
+    ThreadPool pool(numberOfBootstrapThreads());
+    auto index = 0u;
+    for (auto const &result : results) {
+      auto &cellIntervals = intervals[index++];
+      pool.addToQueue([&result, &cellIntervals, numberOfResamples]() {
+        RandomStream const randomStream(
+            OtherSimulationSettings::m_sweepSeed, result.first.first,
+            result.first.second, BOOTSTRAP_STREAM);
+        cellIntervals = result.second.bootstrapFractionIntervals(
+            randomStream, numberOfResamples);
+      });
+    }
+  }
+  return intervals;
 }
 
-void OutFileProcessor::saveResults(std::string const &filename,
-                                   std::string const &fileText) const {
-  auto fileManager = std::make_unique<FileManager>(m_directory + filename);
-  auto const header =
-      "Pericentre  PlanetDistance  HillsRadius  BhBoundFraction  "
-      "StarBoundFraction  UnboundFraction  BhBoundFractionError  "
-      "StarBoundFractionError  UnboundFractionError  SemiMajorBh  "
-      "SemiMajorStar  EccentricityBh  EccentricityStar";
-  fileManager->createNewFile(header + fileText);
-}
+void OutFileProcessor::writeResultRow(
+    ResultsWriter &writer, std::pair<double, double> const &parameters,
+    MutableResult const &result,
+    std::array<FractionInterval, 3> const &bootstrapIntervals) const {
+  for (auto const value :
+       {parameters.first, parameters.second, result.hillsRadius(),
+        result.bhBoundFraction(), result.starBoundFraction(),
+        result.unboundFraction(), result.bhBoundFractionError(),
+        result.starBoundFractionError(), result.unboundFractionError()})
+    writer.addValue(value);
+
+  for (auto const &interval :
+       {result.bhBoundFractionInterval(), result.starBoundFractionInterval(),
+        result.unboundFractionInterval()})
+    addInterval(writer, interval);
+  if (OtherSimulationSettings::m_bootstrapResamples > 0)
+    for (auto const &interval : bootstrapIntervals)
+      addInterval(writer, interval);
+
+  for (auto const &distribution : DISTRIBUTIONS) {
+    auto const &quantiles = (result.*distribution.m_distribution)().quantiles();
+    for (auto const &quantile : QUANTILES)
+      writer.addValue(quantiles.quantile(quantile.first));
+  }
 
-std::map<std::pair<double, double>, MutableResult>
-OutFileProcessor::combineResults() const {
-  auto combinedResults = m_resultsA;
-  combinedResults.insert(m_resultsB.begin(), m_resultsB.end());
-  return combinedResults;
+  if (OtherSimulationSettings::m_writeOrbitalElements) {
+    writer.addList(result.semiMajorsBh());
+    writer.addList(result.eccentricitiesBh());
+  }
+  writer.endRow();
 }
 
-std::string OutFileProcessor::generateResultsFileText(
+// A line of bin counts for each orbital element of each result, after the bin
+// edges of the semi-major axes and eccentricities
+void OutFileProcessor::writeHistograms(
+    std::string const &filename,
     std::map<std::pair<double, double>, MutableResult> const &results) const {
-  std::string fileText;
-  for (auto const &result : results)
-    fileText += generateResultFileLine(result.first, result.second);
-  return std::move(fileText);
-}
-
-std::string OutFileProcessor::generateResultFileLine(
-    std::pair<double, double> const &parameters,
-    MutableResult const &result) const {
-  auto line = "\n" + std::to_string(parameters.first) + " " +
-              std::to_string(parameters.second) + " " +
-              std::to_string(result.hillsRadius()) + " " +
-              std::to_string(result.bhBoundFraction()) + " " +
-              std::to_string(result.starBoundFraction()) + " " +
-              std::to_string(result.unboundFraction()) + " " +
-              std::to_string(result.bhBoundFractionError()) + " " +
-              std::to_string(result.starBoundFractionError()) + " " +
-              std::to_string(result.unboundFractionError());
-
-  for (auto const &semiMajor : result.semiMajorsBh())
-    line += " " + std::to_string(semiMajor);
-  for (auto const &eccentricity : result.eccentricitiesBh())
-    line += " " + std::to_string(eccentricity);
-
-  return line;
+  BufferedFileWriter file(filename);
+  file.append(
+      "Pericentre  PlanetDistance  Element  Underflow  BinCounts  Overflow");
+  writeHistogramEdges(file, "SemiMajorEdges",
+                      ElementDistribution::semiMajorAxes().histogram());
+  writeHistogramEdges(file, "EccentricityEdges",
+                      ElementDistribution::eccentricities().histogram());
+
+  for (auto const &result : results) {
+    for (auto const &distribution : DISTRIBUTIONS) {
+      auto const &histogram =
+          (result.second.*distribution.m_distribution)().histogram();
+      file.append('\n');
+      ResultsWriter::appendFixed(file, result.first.first);
+      file.append(' ');
+      ResultsWriter::appendFixed(file, result.first.second);
+      file.append(' ');
+      file.append(distribution.m_name);
+      file.append(' ');
+      ResultsWriter::appendInteger(file, histogram.underflow());
+      for (auto const count : histogram.binCounts()) {
+        file.append(' ');
+        ResultsWriter::appendInteger(file, count);
+      }
+      file.append(' ');
+      ResultsWriter::appendInteger(file, histogram.overflow());
+    }
+  }
+  file.finish();
 }
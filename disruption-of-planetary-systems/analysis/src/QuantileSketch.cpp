@@ -0,0 +1,86 @@
+#include "QuantileSketch.h"
+
+#include <cmath>
+
+namespace {
+
+// Values this close to zero are counted as zeros
+double constexpr SMALLEST_VALUE = 1e-300;
+
+double const GAMMA = (1.0 + QuantileSketch::RELATIVE_ACCURACY) /
+                     (1.0 - QuantileSketch::RELATIVE_ACCURACY);
+double const LOG_GAMMA = std::log(GAMMA);
+
+} // namespace
+
+QuantileSketch::QuantileSketch() : m_zeroCount(0), m_count(0) {}
+
+QuantileSketch::~QuantileSketch() {}
+
+void QuantileSketch::add(double value) {
+  ++m_count;
+  if (!(value > SMALLEST_VALUE)) {
+    ++m_zeroCount;
+    return;
+  }
+  ++m_buckets[bucketIndex(value)];
+  foldLowestBuckets();
+}
+
+void QuantileSketch::merge(QuantileSketch const &otherSketch) {
+  for (auto const &bucket : otherSketch.m_buckets)
+    m_buckets[bucket.first] += bucket.second;
+  m_zeroCount += otherSketch.m_zeroCount;
+  m_count += otherSketch.m_count;
+  foldLowestBuckets();
+}
+
+std::uint64_t QuantileSketch::count() const { return m_count; }
+
+// The value below which the fraction of the values lie, or zero if there are
+// no values
+double QuantileSketch::quantile(double fraction) const {
+  if (m_count == 0)
+    return 0.0;
+
+  auto const rank = static_cast<std::uint64_t>(
+      std::floor(fraction * static_cast<double>(m_count - 1)));
+  auto cumulativeCount = m_zeroCount;
+  if (rank < cumulativeCount)
+    return 0.0;
+  for (auto const &bucket : m_buckets) {
+    cumulativeCount += bucket.second;
+    if (rank < cumulativeCount)
+      return bucketValue(bucket.first);
+  }
+  return bucketValue(m_buckets.rbegin()->first);
+}
+
+int QuantileSketch::bucketIndex(double value) const {
+  return static_cast<int>(std::ceil(std::log(value) / LOG_GAMMA));
+}
+
+// The value within the relative accuracy of every value in the bucket
+double QuantileSketch::bucketValue(int index) const {
+  return 2.0 * std::pow(GAMMA, index) / (GAMMA + 1.0);
+}
+
+// Folds the buckets below the lowest of the MAXIMUM_BUCKETS indices up to the
+// highest into that index. The index only depends on the highest bucket, so the
+// counts are the same however the values were split before being merged.
+void QuantileSketch::foldLowestBuckets() {
+  if (m_buckets.empty())
+    return;
+
+  auto const lowestIndex =
+      m_buckets.rbegin()->first - static_cast<int>(MAXIMUM_BUCKETS) + 1;
+  auto const lowestKept = m_buckets.lower_bound(lowestIndex);
+  if (lowestKept == m_buckets.begin())
+    return;
+
+  std::uint64_t foldedCount = 0;
+  for (auto bucket = m_buckets.begin(); bucket != lowestKept; ++bucket)
+    foldedCount += bucket->second;
+  m_buckets.erase(m_buckets.begin(), lowestKept);
+  m_buckets[lowestIndex] += foldedCount;
+}
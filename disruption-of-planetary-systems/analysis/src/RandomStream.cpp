@@ -0,0 +1,60 @@
+#include "RandomStream.h"
+
+#include <cstring>
+
+namespace {
+
+std::uint64_t constexpr GOLDEN_GAMMA = 0x9E3779B97F4A7C15ull;
+
+// The SplitMix64 finalizer
+std::uint64_t mix(std::uint64_t value) {
+  value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+  value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+  return value ^ (value >> 31);
+}
+
+std::uint64_t toBits(double value) {
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+std::uint64_t combine(std::uint64_t key, std::uint64_t value) {
+  return mix(key ^ (value + GOLDEN_GAMMA + (key << 6) + (key >> 2)));
+}
+
+} // namespace
+
+RandomStream::RandomStream(std::uint64_t sweepSeed, double pericentre,
+                           double planetDistance, std::size_t orientationIndex)
+    : m_key(combine(combine(combine(mix(sweepSeed), toBits(pericentre)),
+                            toBits(planetDistance)),
+                    orientationIndex)) {}
+
+RandomStream::RandomStream(std::uint64_t sweepSeed, double pericentre,
+                           double planetDistanceA, double planetDistanceB,
+                           std::size_t orientationIndex)
+    : m_key(combine(
+          combine(combine(combine(mix(sweepSeed), toBits(pericentre)),
+                          toBits(planetDistanceA)),
+                  toBits(planetDistanceB)),
+          orientationIndex)) {}
+
+RandomStream::~RandomStream() {}
+
+std::uint64_t RandomStream::value(std::uint64_t counter) const {
+  return mix(m_key + (counter + 1) * GOLDEN_GAMMA);
+}
+
+std::size_t RandomStream::uniformInteger(std::uint64_t counter,
+                                         std::size_t lower,
+                                         std::size_t higher) const {
+  return static_cast<std::size_t>(value(counter) % (higher - lower) + lower);
+}
+
+double RandomStream::uniformDouble(std::uint64_t counter, double lower,
+                                   double higher) const {
+  auto const unit =
+      static_cast<double>(value(counter) >> 11) * (1.0 / 9007199254740992.0);
+  return unit * (higher - lower) + lower;
+}
@@ -0,0 +1,35 @@
+#include "ReplayOutFileSource.h"
+#include "SweepFiles.h"
+
+#include "PackedFile.h"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+ReplayOutFileSource::ReplayOutFileSource(std::string const &directory)
+    : m_directory(directory) {
+  if (std::filesystem::exists(m_directory + SweepFiles::OUT_PACK))
+    m_outPack =
+        std::make_unique<PackedFileReader>(m_directory + SweepFiles::OUT_PACK);
+}
+
+ReplayOutFileSource::~ReplayOutFileSource() {}
+
+void ReplayOutFileSource::writeOutFile(InitSimulationParams const &parameters,
+                                       std::string const &outFilename) const {
+  auto const filename = parameters.filename();
+  if (m_outPack && m_outPack->contains(filename)) {
+    std::ofstream fileStream(outFilename, std::ios::binary);
+    if (!(fileStream << m_outPack->read(filename)))
+      throw std::runtime_error("could not write its recorded .out file");
+    return;
+  }
+
+  std::error_code error;
+  std::filesystem::copy_file(
+      m_directory + filename + ".out", outFilename,
+      std::filesystem::copy_options::overwrite_existing, error);
+  if (error)
+    throw std::runtime_error("has no recorded .out file in " + m_directory);
+}
@@ -0,0 +1,79 @@
+#include "ResultGrid.h"
+#include "SimulationConstants.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+using namespace SimulationConstants;
+
+namespace {
+
+// The sorted distinct values along an axis of the grid
+std::vector<double> gridAxis(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+  return values;
+}
+
+std::size_t axisIndex(std::vector<double> const &axis, double value) {
+  auto const iter = std::lower_bound(axis.begin(), axis.end(), value);
+  if (iter == axis.end() || *iter != value)
+    throw std::runtime_error("The value " + std::to_string(value) +
+                             " is not in the sweep.");
+  return static_cast<std::size_t>(iter - axis.begin());
+}
+
+double calculateHillsRadius(double pericentre) {
+  return pericentre * pow(STAR_MASS / (3 * BH_MASS), 1.0 / 3.0);
+}
+
+} // namespace
+
+ResultGrid::ResultGrid(std::vector<double> const &pericentres,
+                       std::vector<double> const &planetDistances)
+    : m_pericentres(gridAxis(pericentres)),
+      m_planetDistances(gridAxis(planetDistances)) {
+  m_cells.reserve(m_pericentres.size() * m_planetDistances.size());
+  for (auto const pericentre : m_pericentres)
+    for (auto i = 0u; i < m_planetDistances.size(); ++i)
+      m_cells.emplace_back(calculateHillsRadius(pericentre), 0u, 0u, 0u,
+                           std::vector<double>(), std::vector<double>(),
+                           std::vector<double>(), std::vector<double>());
+}
+
+ResultGrid::~ResultGrid() {}
+
+void ResultGrid::addOutcome(double pericentre, double planetDistance,
+                            std::uint64_t runId, RunOutcome const &outcome) {
+  m_cells[cellIndex(pericentre, planetDistance)].addOutcome(runId, outcome);
+}
+
+void ResultGrid::merge(ResultGrid const &otherGrid) {
+  for (auto i = 0u; i < m_cells.size(); ++i)
+    m_cells[i].merge(otherGrid.m_cells[i]);
+}
+
+std::map<std::pair<double, double>, MutableResult>
+ResultGrid::results() const {
+  std::map<std::pair<double, double>, MutableResult> results;
+  for (auto i = 0u; i < m_pericentres.size(); ++i) {
+    for (auto j = 0u; j < m_planetDistances.size(); ++j) {
+      auto const &cell = m_cells[i * m_planetDistances.size() + j];
+      if (cell.totalCount() == 0)
+        continue;
+      auto const result = results.emplace_hint(
+          results.end(), std::make_pair(m_pericentres[i], m_planetDistances[j]),
+          cell);
+      result->second.orderByRunId();
+    }
+  }
+  return results;
+}
+
+std::size_t ResultGrid::cellIndex(double pericentre,
+                                  double planetDistance) const {
+  return axisIndex(m_pericentres, pericentre) * m_planetDistances.size() +
+         axisIndex(m_planetDistances, planetDistance);
+}
@@ -0,0 +1,145 @@
+#include "ResultsWriter.h"
+
+#include <charconv>
+#include <cstdint>
+#include <stdexcept>
+
+namespace {
+
+char const BINARY_MAGIC[] = "DPSRES01";
+std::size_t constexpr BINARY_ALIGNMENT = 8;
+
+// Large enough for any double in fixed notation with six decimals
+std::size_t constexpr NUMBER_BUFFER_SIZE = 512;
+
+void appendBinaryInteger(BufferedFileWriter &file, std::uint64_t value) {
+  file.append(reinterpret_cast<char const *>(&value), sizeof(value));
+}
+
+template <typename... Format>
+void appendFormatted(BufferedFileWriter &file, Format... format) {
+  char characters[NUMBER_BUFFER_SIZE];
+  auto const result =
+      std::to_chars(characters, characters + NUMBER_BUFFER_SIZE, format...);
+  if (result.ec != std::errc())
+    throw std::runtime_error("Failed to format a number for a results file.");
+  file.append(characters, static_cast<std::size_t>(result.ptr - characters));
+}
+
+} // namespace
+
+ResultsWriter::ResultsWriter(std::string const &filename, ResultsFormat format,
+                             std::vector<std::string> const &columns,
+                             std::vector<std::string> const &listColumns)
+    : m_filename(filename), m_format(format), m_numberOfColumns(columns.size()),
+      m_numberOfListColumns(listColumns.size()), m_file(filename),
+      m_numberOfValues(0), m_numberOfLists(0) {
+  writeHeader(columns, listColumns);
+}
+
+ResultsWriter::~ResultsWriter() {}
+
+std::string ResultsWriter::extension(ResultsFormat format) {
+  switch (format) {
+  case ResultsFormat::CSV:
+    return ".csv";
+  case ResultsFormat::Binary:
+    return ".bin";
+  default:
+    return ".txt";
+  }
+}
+
+void ResultsWriter::writeHeader(std::vector<std::string> const &columns,
+                                std::vector<std::string> const &listColumns) {
+  if (m_format == ResultsFormat::Binary) {
+    std::string names;
+    for (auto const &column : columns)
+      names += column + '\0';
+    names.resize((names.size() + BINARY_ALIGNMENT - 1) / BINARY_ALIGNMENT *
+                     BINARY_ALIGNMENT,
+                 '\0');
+
+    m_file.append(BINARY_MAGIC, sizeof(BINARY_MAGIC) - 1);
+    appendBinaryInteger(m_file, columns.size());
+    appendBinaryInteger(m_file, names.size());
+    m_file.append(names);
+    return;
+  }
+
+  auto const separator = m_format == ResultsFormat::CSV ? "," : "  ";
+  std::string header;
+  for (auto const *names : {&columns, &listColumns})
+    for (auto const &column : *names)
+      header += (header.empty() ? "" : separator) + column;
+  m_file.append(header);
+  if (m_format == ResultsFormat::CSV)
+    m_file.append('\n');
+}
+
+void ResultsWriter::addValue(double value) {
+  if (m_numberOfValues == m_numberOfColumns || m_numberOfLists > 0)
+    throw std::runtime_error("Too many values for a row of " + m_filename +
+                             ".");
+
+  if (m_format == ResultsFormat::Binary)
+    m_file.append(reinterpret_cast<char const *>(&value), sizeof(value));
+  else {
+    // Text rows start on a new line, as the file has no trailing newline
+    if (m_numberOfValues > 0)
+      m_file.append(m_format == ResultsFormat::CSV ? ',' : ' ');
+    else if (m_format == ResultsFormat::Text)
+      m_file.append('\n');
+    appendNumber(value);
+  }
+  ++m_numberOfValues;
+}
+
+void ResultsWriter::addList(std::vector<double> const &values) {
+  if (m_numberOfValues != m_numberOfColumns ||
+      m_numberOfLists == m_numberOfListColumns)
+    throw std::runtime_error("Unexpected list in a row of " + m_filename +
+                             ".");
+  ++m_numberOfLists;
+
+  if (m_format == ResultsFormat::Binary)
+    return;
+  if (m_format == ResultsFormat::CSV)
+    m_file.append(',');
+  for (auto i = 0u; i < values.size(); ++i) {
+    if (m_format == ResultsFormat::Text || i > 0)
+      m_file.append(m_format == ResultsFormat::CSV ? ';' : ' ');
+    appendNumber(values[i]);
+  }
+}
+
+void ResultsWriter::endRow() {
+  if (m_numberOfValues != m_numberOfColumns ||
+      m_numberOfLists != m_numberOfListColumns)
+    throw std::runtime_error("Incomplete row in " + m_filename + ".");
+
+  if (m_format == ResultsFormat::CSV)
+    m_file.append('\n');
+  m_numberOfValues = 0;
+  m_numberOfLists = 0;
+}
+
+void ResultsWriter::finish() { m_file.finish(); }
+
+void ResultsWriter::appendFixed(BufferedFileWriter &file, double value) {
+  appendFormatted(file, value, std::chars_format::fixed, 6);
+}
+
+void ResultsWriter::appendInteger(BufferedFileWriter &file,
+                                  std::uint64_t value) {
+  appendFormatted(file, value);
+}
+
+// Text files use the six decimals of std::to_string, while CSV files use the
+// shortest representation that reads back to the same double
+void ResultsWriter::appendNumber(double value) {
+  if (m_format == ResultsFormat::Text)
+    appendFixed(m_file, value);
+  else
+    appendFormatted(m_file, value);
+}
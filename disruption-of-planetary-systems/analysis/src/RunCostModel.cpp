@@ -0,0 +1,100 @@
+#include "RunCostModel.h"
+#include "InitFileSerializer.h"
+#include "InitSimulationParams.h"
+
+#include "Logger.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+RunCostModel::RunCostModel(std::string const &directory)
+    : m_filename(directory + "run_costs.txt") {}
+
+RunCostModel::~RunCostModel() {}
+
+void RunCostModel::load() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_timings.clear();
+
+  std::ifstream fileStream(m_filename);
+  std::string line;
+  while (std::getline(fileStream, line)) {
+    std::istringstream lineStream(line);
+    double pericentre, planetDistanceA, planetDistanceB, totalSeconds;
+    std::size_t numberOfRuns;
+    if (lineStream >> pericentre >> planetDistanceA >> planetDistanceB >>
+            totalSeconds >> numberOfRuns &&
+        numberOfRuns > 0)
+      m_timings[Cell(pericentre, planetDistanceA, planetDistanceB)] =
+          CellTiming{totalSeconds, numberOfRuns};
+  }
+}
+
+void RunCostModel::save() const {
+  std::string fileText;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (auto const &timing : m_timings) {
+      InitFileSerializer::appendNumber(fileText, std::get<0>(timing.first));
+      fileText += ' ';
+      InitFileSerializer::appendNumber(fileText, std::get<1>(timing.first));
+      fileText += ' ';
+      InitFileSerializer::appendNumber(fileText, std::get<2>(timing.first));
+      fileText += ' ';
+      InitFileSerializer::appendNumber(fileText, timing.second.m_totalSeconds);
+      fileText += ' ';
+      InitFileSerializer::appendNumber(fileText, timing.second.m_numberOfRuns);
+      fileText += '\n';
+    }
+  }
+
+  std::ofstream fileStream(m_filename);
+  if (!(fileStream << fileText))
+    Logger::getInstance().addLog(LogType::Warning,
+                                 "Failed to save the run timings to " +
+                                     m_filename + ".");
+}
+
+double RunCostModel::predictedCost(double pericentre, double planetDistanceA,
+                                   double planetDistanceB) const {
+  Cell const cell(pericentre, planetDistanceA, planetDistanceB);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  auto const iter = m_timings.find(cell);
+  if (iter != m_timings.end())
+    return iter->second.m_totalSeconds /
+           static_cast<double>(iter->second.m_numberOfRuns);
+  return numberOfTimeSteps(cell) * secondsPerTimeStep();
+}
+
+void RunCostModel::recordRun(InitSimulationParams const &parameters,
+                             double seconds) {
+  Cell const cell(parameters.m_pericentre, parameters.m_planetDistances[0],
+                  parameters.m_planetDistances[1]);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  auto &timing = m_timings[cell];
+  timing.m_totalSeconds += seconds;
+  ++timing.m_numberOfRuns;
+}
+
+double RunCostModel::numberOfTimeSteps(Cell const &cell) const {
+  // The header of a run uses its largest planet distance
+  return static_cast<double>(InitHeaderData::numberOfTimeStep(
+      std::get<0>(cell), std::max(std::get<1>(cell), std::get<2>(cell))));
+}
+
+double RunCostModel::secondsPerTimeStep() const {
+  auto totalSeconds = 0.0;
+  auto totalTimeSteps = 0.0;
+  for (auto const &timing : m_timings) {
+    totalSeconds += timing.second.m_totalSeconds;
+    totalTimeSteps += numberOfTimeSteps(timing.first) *
+                      static_cast<double>(timing.second.m_numberOfRuns);
+  }
+
+  if (totalSeconds > 0.0 && totalTimeSteps > 0.0)
+    return totalSeconds / totalTimeSteps;
+  return 1.0;
+}
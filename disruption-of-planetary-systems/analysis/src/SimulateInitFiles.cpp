@@ -1,21 +1,21 @@
 #include "SimulateInitFiles.h"
 #include "InitSimulationParams.h"
+#include "SimulationParamsStream.h"
+#include "SweepFiles.h"
+#include "SweepJournal.h"
 
 #include "FileManager.h"
 #include "Logger.h"
+#include "PackedFile.h"
 #include "TaskRunner.h"
 
+#include <algorithm>
+#include <cstdio>
 #include <cstdlib>
 #include <math.h>
 
 namespace {
 
-char *toChar(std::string const &str) {
-  char *cstr = new char[str.length() + 1];
-  strcpy_s(cstr, str.length() + 1, str.c_str());
-  return cstr;
-}
-
 std::size_t calculateNumberOfIntermissions(std::size_t numberOfSimulations,
                                            std::size_t stepSize) {
   return static_cast<std::size_t>(
@@ -26,9 +26,10 @@ std::size_t calculateNumberOfIntermissions(std::size_t numberOfSimulations,
 } // namespace
 
 InitFileSimulator::InitFileSimulator(std::string const &drive,
-                                     std::string const &subDirectory)
+                                     std::string const &subDirectory,
+                                     SweepJournal &journal)
     : m_drive(drive), m_subDirectory(subDirectory),
-      m_directory(m_drive + "/" + m_subDirectory),
+      m_directory(m_drive + "/" + m_subDirectory), m_journal(journal),
       m_taskRunner(TaskRunner::getInstance()) {
   m_fileManager =
       std::make_unique<FileManager>(m_directory + "run_simulation.sh");
@@ -36,49 +37,62 @@ InitFileSimulator::InitFileSimulator(std::string const &drive,
 
 InitFileSimulator::~InitFileSimulator() {}
 
-void InitFileSimulator::resetSimulator(std::size_t numberOfIntermissions) {
+void InitFileSimulator::resetSimulator(std::size_t numberOfSteps) {
   m_taskRunner.setTask("Simulating init files...", 10.0, 20.0);
-  m_taskRunner.setNumberOfSteps(numberOfIntermissions);
+  m_taskRunner.setNumberOfSteps(numberOfSteps);
 }
 
-bool InitFileSimulator::simulateInitFiles(
-    std::vector<InitSimulationParams> const &simulationParameters) {
-  auto const numberOfSimulations = simulationParameters.size();
-  auto const numberOfIntermissions =
-      calculateNumberOfIntermissions(numberOfSimulations, m_step);
-  auto const remainder = numberOfSimulations % m_step;
+bool InitFileSimulator::simulateInitFiles(SweepDefinition const &sweep) {
+  SimulationParamsStream parametersStream(sweep);
+  openPackedFiles();
+
+  auto const completed = runInitFileBatches(parametersStream);
 
-  return simulateInitFiles(simulationParameters, numberOfIntermissions,
-                           remainder);
+  closePackedFiles();
+  if (completed)
+    deleteInitFiles(sweep);
+  return completed;
 }
 
-bool InitFileSimulator::simulateInitFiles(
-    std::vector<InitSimulationParams> const &simulationParameters,
-    std::size_t numberOfIntermissions, std::size_t remainder) {
-  resetSimulator(numberOfIntermissions);
+bool InitFileSimulator::runInitFileBatches(
+    SimulationParamsStream &parametersStream) {
+  resetSimulator(
+      calculateNumberOfIntermissions(parametersStream.size(), m_step));
 
-  for (auto i = 0u; i < numberOfIntermissions; ++i) {
-    if (m_taskRunner.isRunning())
-      simulateInitFiles(simulationParameters.begin(), numberOfIntermissions,
-                        remainder, i);
-    else
+  std::vector<InitSimulationParams> parameters;
+  parameters.reserve(m_step);
+  while (parametersStream.next(parameters, m_step)) {
+    if (!m_taskRunner.isRunning())
       return false;
-  }
 
-  deleteInitFiles(simulationParameters);
+    parameters.erase(
+        std::remove_if(parameters.begin(), parameters.end(),
+                       [this](InitSimulationParams const &simParameters) {
+                         return m_journal.state(simParameters) >=
+                                RunState::Simulated;
+                       }),
+        parameters.end());
+    if (parameters.empty())
+      m_taskRunner.reportProgress();
+    else
+      simulateInitFiles(parameters.cbegin(), parameters.cend());
+  }
   return true;
 }
 
-void InitFileSimulator::simulateInitFiles(
-    std::vector<InitSimulationParams>::const_iterator const &beginIter,
-    std::size_t numberOfIntermissions, std::size_t remainder,
-    std::size_t index) const {
-  if (index != numberOfIntermissions - 1 || remainder == 0)
-    simulateInitFiles(beginIter + index * m_step,
-                      beginIter + (index + 1) * m_step);
-  else
-    simulateInitFiles(beginIter + index * m_step,
-                      beginIter + index * m_step + remainder);
+void InitFileSimulator::openPackedFiles() {
+  if (OtherSimulationSettings::m_usePackedFiles) {
+    m_initPack =
+        std::make_unique<PackedFileReader>(m_directory + SweepFiles::INIT_PACK);
+    m_outPack = std::make_unique<PackedFileWriter>(
+        m_directory + SweepFiles::OUT_PACK,
+        !OtherSimulationSettings::m_resumeSweep);
+  }
+}
+
+void InitFileSimulator::closePackedFiles() {
+  m_initPack.reset();
+  m_outPack.reset();
 }
 
 void InitFileSimulator::simulateInitFiles(
@@ -88,31 +102,63 @@ void InitFileSimulator::simulateInitFiles(
 
   auto const cmd =
       m_drive + " && cd " + m_subDirectory + " && run_simulation.sh";
-  system(toChar(cmd));
+  system(cmd.c_str());
+
+  if (m_outPack)
+    packOutFiles(startIter, endIter);
+  for (auto it = startIter; it < endIter; ++it)
+    m_journal.recordSimulated(*it);
 
   m_taskRunner.reportProgress();
 }
 
+void InitFileSimulator::packOutFiles(
+    std::vector<InitSimulationParams>::const_iterator const &startIter,
+    std::vector<InitSimulationParams>::const_iterator const &endIter) const {
+  for (auto it = startIter; it < endIter; ++it) {
+    auto const filename = it->filename();
+    m_outPack->appendFile(filename, m_directory + filename + ".out");
+    deleteFile(filename + ".out");
+  }
+  m_outPack->flush();
+}
+
 std::string InitFileSimulator::getCommand(
     std::vector<InitSimulationParams>::const_iterator const &startIter,
     std::vector<InitSimulationParams>::const_iterator const &endIter) const {
   std::string cmd;
   for (auto it = startIter; it < endIter; ++it) {
-    cmd += "./NewARC.out <" + it->m_filename + ".init> data.log";
+    cmd += getCommand(*it);
     if (*it != *(endIter - 1))
       cmd += "\n";
   }
   return std::move(cmd);
 }
 
-void InitFileSimulator::deleteInitFiles(
-    std::vector<InitSimulationParams> const &simulationParameters) const {
-  for (auto const &parameters : simulationParameters)
-    deleteFile(parameters.m_filename + ".init");
+std::string
+InitFileSimulator::getCommand(InitSimulationParams const &parameters) const {
+  // Packed init records are passed to the integrator through a here-document
+  if (m_initPack)
+    return "./NewARC.out > data.log << 'INIT'\n" +
+           m_initPack->read(parameters.filename()) + "\nINIT";
+  return "./NewARC.out <" + parameters.filename() + ".init> data.log";
+}
+
+void InitFileSimulator::deleteInitFiles(SweepDefinition const &sweep) const {
+  if (OtherSimulationSettings::m_usePackedFiles) {
+    PackedFile::remove(m_directory + SweepFiles::INIT_PACK);
+    return;
+  }
+
+  SimulationParamsStream parametersStream(sweep);
+  std::vector<InitSimulationParams> parameters;
+  while (parametersStream.next(parameters, m_step))
+    for (auto const &simParameters : parameters)
+      deleteFile(simParameters.filename() + ".init");
 }
 
 void InitFileSimulator::deleteFile(std::string const &filename) const {
-  if (remove(toChar(m_directory + filename)) != 0) {
+  if (remove((m_directory + filename).c_str()) != 0) {
     Logger::getInstance().addLog(LogType::Warning,
                                  "Failed to delete file " + filename + ".");
   }
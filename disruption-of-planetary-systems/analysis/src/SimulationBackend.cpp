@@ -0,0 +1,40 @@
+#include "SimulationBackend.h"
+#include "InitSimulationParams.h"
+#include "IntegratorScheduler.h"
+#include "MockOutFileSource.h"
+#include "ReplayOutFileSource.h"
+#include "SyntheticBackend.h"
+
+#include <stdexcept>
+
+SimulationBackend::~SimulationBackend() {}
+
+std::unique_ptr<SimulationBackend> createSimulationBackend(
+    std::string const &directory, std::size_t numberOfWorkers,
+    SimulationBackend::CompletionHandler const &completionHandler,
+    std::function<bool()> const &keepRunning) {
+  switch (OtherSimulationSettings::m_integratorBackend) {
+  case IntegratorBackend::Mock:
+    return std::make_unique<SyntheticBackend>(
+        directory, numberOfWorkers, std::make_unique<MockOutFileSource>(),
+        completionHandler, keepRunning);
+  case IntegratorBackend::Replay:
+    return std::make_unique<SyntheticBackend>(
+        directory, numberOfWorkers,
+        std::make_unique<ReplayOutFileSource>(
+            OtherSimulationSettings::m_replayDirectory.empty()
+                ? directory
+                : OtherSimulationSettings::m_replayDirectory),
+        completionHandler, keepRunning);
+  case IntegratorBackend::InProcess:
+    throw std::runtime_error("The built-in integrator does not write .out "
+                             "files.");
+  default:
+#ifdef __linux__
+    return std::make_unique<IntegratorScheduler>(
+        directory, numberOfWorkers, completionHandler, keepRunning);
+#else
+    throw std::runtime_error("NewARC.out can only be scheduled on Linux.");
+#endif
+  }
+}
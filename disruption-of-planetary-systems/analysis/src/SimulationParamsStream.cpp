@@ -0,0 +1,157 @@
+#include "SimulationParamsStream.h"
+
+#include "InitSimulationParams.h"
+#include "RandomStream.h"
+#include "RunCostModel.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+std::vector<double> toDoubles(std::vector<std::string> const &values) {
+  std::vector<double> doubles;
+  doubles.reserve(values.size());
+  for (auto const &value : values)
+    doubles.emplace_back(std::stod(value));
+  return doubles;
+}
+
+} // namespace
+
+/*
+The pericentres, planet distances and number of orientations making up a sweep
+*/
+SweepDefinition::SweepDefinition(
+    std::vector<std::string> const &pericentres,
+    std::vector<std::string> const &planetDistancesA,
+    std::vector<std::string> const &planetDistancesB,
+    std::size_t numberOfOrientations)
+    : m_pericentres(pericentres), m_planetDistancesA(planetDistancesA),
+      m_planetDistancesB(planetDistancesB),
+      m_numberOfOrientations(numberOfOrientations),
+      m_pericentreValues(toDoubles(pericentres)),
+      m_planetDistanceAValues(toDoubles(planetDistancesA)) {
+  if (!OtherSimulationSettings::m_hasSinglePlanet)
+    m_planetDistanceBValues = toDoubles(planetDistancesB);
+}
+
+SweepDefinition::~SweepDefinition() {}
+
+std::size_t SweepDefinition::numberOfSimulations() const {
+  auto const numberOfVisitedCells =
+      m_cellOrder.empty() ? numberOfCells() : m_cellOrder.size();
+  return numberOfVisitedCells * m_numberOfOrientations;
+}
+
+std::size_t SweepDefinition::numberOfCells() const {
+  return m_pericentres.size() * m_planetDistancesA.size();
+}
+
+void SweepDefinition::selectCells(std::vector<std::size_t> const &cells) {
+  for (auto const cell : cells)
+    if (cell >= numberOfCells())
+      throw std::runtime_error("The sweep has no cell " +
+                               std::to_string(cell) + ".");
+  m_cellOrder = cells;
+}
+
+void SweepDefinition::orderCellsByCost(RunCostModel const &costModel) {
+  std::vector<double> costs;
+  costs.reserve(numberOfCells());
+  for (auto cell = 0u; cell < numberOfCells(); ++cell)
+    costs.emplace_back(predictedCellCost(costModel, cell));
+
+  // The longest runs are started first so that no long run is left to finish
+  // on its own at the end of the sweep
+  if (m_cellOrder.empty()) {
+    m_cellOrder.resize(numberOfCells());
+    for (auto i = 0u; i < m_cellOrder.size(); ++i)
+      m_cellOrder[i] = i;
+  }
+  std::stable_sort(m_cellOrder.begin(), m_cellOrder.end(),
+                   [&costs](std::size_t cellA, std::size_t cellB) {
+                     return costs[cellA] > costs[cellB];
+                   });
+}
+
+// The same cells visited in run ID order, undoing any ordering by cost
+SweepDefinition SweepDefinition::inRunOrder() const {
+  auto sweep = *this;
+  std::sort(sweep.m_cellOrder.begin(), sweep.m_cellOrder.end());
+  return sweep;
+}
+
+double SweepDefinition::predictedCellCost(RunCostModel const &costModel,
+                                          std::size_t cell) const {
+  auto const distanceIndex = cell % m_planetDistancesA.size();
+  return costModel.predictedCost(
+      m_pericentreValues[cell / m_planetDistancesA.size()],
+      m_planetDistanceAValues[distanceIndex],
+      m_planetDistanceBValues.empty() ? 0.0
+                                      : m_planetDistanceBValues[distanceIndex]);
+}
+
+/*
+Lazily produces the simulation parameters of a sweep
+*/
+SimulationParamsStream::SimulationParamsStream(SweepDefinition const &sweep)
+    : m_sweep(sweep), m_size(sweep.numberOfSimulations()), m_position(0),
+      m_mutex() {}
+
+SimulationParamsStream::~SimulationParamsStream() {}
+
+std::size_t SimulationParamsStream::size() const { return m_size; }
+
+bool SimulationParamsStream::next(std::vector<InitSimulationParams> &chunk,
+                                  std::size_t maximumChunkSize) {
+  chunk.clear();
+
+  std::size_t first, last;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    first = m_position;
+    last = std::min(m_position + maximumChunkSize, m_size);
+    m_position = last;
+  }
+
+  for (auto index = first; index < last; ++index)
+    chunk.emplace_back(createParameters(index));
+  return !chunk.empty();
+}
+
+InitSimulationParams
+SimulationParamsStream::createParameters(std::size_t position) const {
+  // The run ID is the position of the run in sweep order
+  auto const index =
+      m_sweep.m_cellOrder.empty()
+          ? position
+          : m_sweep.m_cellOrder[position / m_sweep.m_numberOfOrientations] *
+                    m_sweep.m_numberOfOrientations +
+                position % m_sweep.m_numberOfOrientations;
+
+  auto const orientationIndex = index % m_sweep.m_numberOfOrientations + 1;
+  auto const distanceIndex = index / m_sweep.m_numberOfOrientations %
+                             m_sweep.m_planetDistancesA.size();
+  auto const pericentreIndex = index / m_sweep.m_numberOfOrientations /
+                               m_sweep.m_planetDistancesA.size();
+
+  auto parameters =
+      OtherSimulationSettings::m_hasSinglePlanet
+          ? InitSimulationParams(index,
+                                 m_sweep.m_pericentreValues[pericentreIndex],
+                                 m_sweep.m_planetDistanceAValues[distanceIndex],
+                                 orientationIndex, 0, 0)
+          : InitSimulationParams(
+                index, m_sweep.m_pericentreValues[pericentreIndex],
+                m_sweep.m_planetDistanceAValues[distanceIndex],
+                m_sweep.m_planetDistanceBValues[distanceIndex],
+                orientationIndex, 0, 0);
+
+  auto const randomStream = parameters.randomStream();
+  parameters.m_phi = static_cast<std::uint16_t>(
+      randomStream.uniformInteger(RandomDraw::Phi, 0, 360));
+  parameters.m_inclination = static_cast<std::uint16_t>(
+      randomStream.uniformInteger(RandomDraw::Inclination, 0, 360));
+  return parameters;
+}
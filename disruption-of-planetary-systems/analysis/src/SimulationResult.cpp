@@ -1,15 +1,40 @@
 #include "SimulationResult.h"
+#include "InitSimulationParams.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
 
 namespace {
 
-std::vector<double> combineVectors(std::size_t combinedSize,
-                                   std::vector<double> const &vec1,
-                                   std::vector<double> const &vec2) {
-  std::vector<double> combined;
-  combined.reserve(combinedSize);
-  combined.insert(combined.begin(), vec1.begin(), vec1.end());
-  combined.insert(combined.begin(), vec2.begin(), vec2.end());
-  return combined;
+template <typename T>
+void appendVector(std::vector<T> &vec, std::vector<T> const &other) {
+  vec.insert(vec.end(), other.begin(), other.end());
+}
+
+// Sorts the orbital elements of the runs by their run IDs
+void orderByRunId(std::vector<std::uint64_t> &runIds,
+                  std::vector<double> &semiMajors,
+                  std::vector<double> &eccentricities) {
+  std::vector<std::size_t> order(runIds.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&runIds](auto const a, auto const b) {
+    return runIds[a] < runIds[b];
+  });
+
+  std::vector<std::uint64_t> orderedRunIds;
+  std::vector<double> orderedSemiMajors, orderedEccentricities;
+  orderedRunIds.reserve(order.size());
+  orderedSemiMajors.reserve(order.size());
+  orderedEccentricities.reserve(order.size());
+  for (auto const index : order) {
+    orderedRunIds.emplace_back(runIds[index]);
+    orderedSemiMajors.emplace_back(semiMajors[index]);
+    orderedEccentricities.emplace_back(eccentricities[index]);
+  }
+  runIds = std::move(orderedRunIds);
+  semiMajors = std::move(orderedSemiMajors);
+  eccentricities = std::move(orderedEccentricities);
 }
 
 } // namespace
@@ -40,16 +65,6 @@ SimulationResult::~SimulationResult() {}
 
 MutableResult::MutableResult() {}
 
-MutableResult::MutableResult(double hillsRadius, bool bhBound, bool starBound,
-                             double semiMajorBh, double semiMajorStar,
-                             double eccentricityBh, double eccentricityStar)
-    : m_result(SimulationResult(hillsRadius, bhBound, starBound, semiMajorBh,
-                                semiMajorStar, eccentricityBh,
-                                eccentricityStar)) {
-  updateCounts(bhBound, starBound);
-  updateAverages(semiMajorBh, semiMajorStar, eccentricityBh, eccentricityStar);
-}
-
 MutableResult::MutableResult(double hillsRadius, std::size_t bhBoundCount,
                              std::size_t starBoundCount, std::size_t totalCount,
                              std::vector<double> semiMajorsBh,
@@ -62,22 +77,39 @@ MutableResult::MutableResult(double hillsRadius, std::size_t bhBoundCount,
 
 MutableResult::~MutableResult() {}
 
-MutableResult MutableResult::operator+(MutableResult const &otherResult) const {
-  auto const other = otherResult.m_result;
+void MutableResult::addOutcome(std::uint64_t runId,
+                               RunOutcome const &outcome) {
+  updateCounts(outcome.m_bhBound, outcome.m_starBound);
+  updateAverages(runId, outcome.m_semiMajorBh, outcome.m_semiMajorStar,
+                 outcome.m_eccentricityBh, outcome.m_eccentricityStar);
+}
+
+// Appends the outcomes of the other result after those of this one
+void MutableResult::merge(MutableResult const &otherResult) {
+  auto const &other = otherResult.m_result;
+  m_result.m_bhBoundCount += other.m_bhBoundCount;
+  m_result.m_starBoundCount += other.m_starBoundCount;
+  m_result.m_totalCount += other.m_totalCount;
+  appendVector(m_result.m_semiMajorsBh, other.m_semiMajorsBh);
+  appendVector(m_result.m_semiMajorsStar, other.m_semiMajorsStar);
+  appendVector(m_result.m_eccentricitiesBh, other.m_eccentricitiesBh);
+  appendVector(m_result.m_eccentricitiesStar, other.m_eccentricitiesStar);
+  appendVector(m_result.m_runIdsBh, other.m_runIdsBh);
+  appendVector(m_result.m_runIdsStar, other.m_runIdsStar);
+  m_result.m_semiMajorBhDistribution.merge(other.m_semiMajorBhDistribution);
+  m_result.m_semiMajorStarDistribution.merge(
+      other.m_semiMajorStarDistribution);
+  m_result.m_eccentricityBhDistribution.merge(
+      other.m_eccentricityBhDistribution);
+  m_result.m_eccentricityStarDistribution.merge(
+      other.m_eccentricityStarDistribution);
+}
 
-  return MutableResult(
-      m_result.m_hillsRadius, m_result.m_bhBoundCount + other.m_bhBoundCount,
-      m_result.m_starBoundCount + other.m_starBoundCount,
-      m_result.m_totalCount + other.m_totalCount,
-      combineVectors(m_result.m_totalCount + other.m_totalCount,
-                     m_result.m_semiMajorsBh, other.m_semiMajorsBh),
-      combineVectors(m_result.m_totalCount + other.m_totalCount,
-                     m_result.m_semiMajorsStar, other.m_semiMajorsStar),
-      combineVectors(m_result.m_totalCount + other.m_totalCount,
-                     m_result.m_eccentricitiesBh, other.m_eccentricitiesBh),
-      combineVectors(m_result.m_totalCount + other.m_totalCount,
-                     m_result.m_eccentricitiesStar,
-                     other.m_eccentricitiesStar));
+void MutableResult::orderByRunId() {
+  ::orderByRunId(m_result.m_runIdsBh, m_result.m_semiMajorsBh,
+                 m_result.m_eccentricitiesBh);
+  ::orderByRunId(m_result.m_runIdsStar, m_result.m_semiMajorsStar,
+                 m_result.m_eccentricitiesStar);
 }
 
 void MutableResult::updateCounts(bool bhBound, bool starBound) {
@@ -88,20 +120,33 @@ void MutableResult::updateCounts(bool bhBound, bool starBound) {
   ++m_result.m_totalCount;
 }
 
-void MutableResult::updateAverages(double semiMajorBh, double semiMajorStar,
-                                   double eccentricityBh,
+void MutableResult::updateAverages(std::uint64_t runId, double semiMajorBh,
+                                   double semiMajorStar, double eccentricityBh,
                                    double eccentricityStar) {
+  auto const keepElements = OtherSimulationSettings::m_writeOrbitalElements;
   if (semiMajorBh != 0.0) {
-    m_result.m_semiMajorsBh.emplace_back(semiMajorBh);
-    m_result.m_eccentricitiesBh.emplace_back(eccentricityBh);
+    m_result.m_semiMajorBhDistribution.add(semiMajorBh);
+    m_result.m_eccentricityBhDistribution.add(eccentricityBh);
+    if (keepElements) {
+      m_result.m_semiMajorsBh.emplace_back(semiMajorBh);
+      m_result.m_eccentricitiesBh.emplace_back(eccentricityBh);
+      m_result.m_runIdsBh.emplace_back(runId);
+    }
   } else if (semiMajorStar != 0.0) {
-    m_result.m_semiMajorsStar.emplace_back(semiMajorStar);
-    m_result.m_eccentricitiesStar.emplace_back(eccentricityStar);
+    m_result.m_semiMajorStarDistribution.add(semiMajorStar);
+    m_result.m_eccentricityStarDistribution.add(eccentricityStar);
+    if (keepElements) {
+      m_result.m_semiMajorsStar.emplace_back(semiMajorStar);
+      m_result.m_eccentricitiesStar.emplace_back(eccentricityStar);
+      m_result.m_runIdsStar.emplace_back(runId);
+    }
   }
 }
 
 double MutableResult::hillsRadius() const { return m_result.m_hillsRadius; }
 
+std::size_t MutableResult::totalCount() const { return m_result.m_totalCount; }
+
 double MutableResult::bhBoundFraction() const {
   return static_cast<double>(m_result.m_bhBoundCount) /
          static_cast<double>(m_result.m_totalCount);
@@ -130,6 +175,30 @@ double MutableResult::unboundFractionError() const {
          m_result.m_totalCount;
 }
 
+FractionInterval MutableResult::bhBoundFractionInterval() const {
+  return FractionIntervals::wilsonInterval(m_result.m_bhBoundCount,
+                                           m_result.m_totalCount);
+}
+
+FractionInterval MutableResult::starBoundFractionInterval() const {
+  return FractionIntervals::wilsonInterval(m_result.m_starBoundCount,
+                                           m_result.m_totalCount);
+}
+
+FractionInterval MutableResult::unboundFractionInterval() const {
+  return FractionIntervals::wilsonInterval(
+      m_result.m_totalCount - m_result.m_bhBoundCount -
+          m_result.m_starBoundCount,
+      m_result.m_totalCount);
+}
+
+std::array<FractionInterval, 3> MutableResult::bootstrapFractionIntervals(
+    RandomStream const &randomStream, std::size_t numberOfResamples) const {
+  return FractionIntervals::bootstrapIntervals(
+      randomStream, m_result.m_bhBoundCount, m_result.m_starBoundCount,
+      m_result.m_totalCount, numberOfResamples);
+}
+
 std::vector<double> MutableResult::semiMajorsBh() const {
   return m_result.m_semiMajorsBh;
 }
@@ -145,3 +214,19 @@ std::vector<double> MutableResult::eccentricitiesBh() const {
 std::vector<double> MutableResult::eccentricitiesStar() const {
   return m_result.m_eccentricitiesStar;
 }
+
+ElementDistribution const &MutableResult::semiMajorBhDistribution() const {
+  return m_result.m_semiMajorBhDistribution;
+}
+
+ElementDistribution const &MutableResult::semiMajorStarDistribution() const {
+  return m_result.m_semiMajorStarDistribution;
+}
+
+ElementDistribution const &MutableResult::eccentricityBhDistribution() const {
+  return m_result.m_eccentricityBhDistribution;
+}
+
+ElementDistribution const &MutableResult::eccentricityStarDistribution() const {
+  return m_result.m_eccentricityStarDistribution;
+}
@@ -0,0 +1,211 @@
+#include "SweepCoordinator.h"
+
+#ifdef __linux__
+
+#include "ProcessOutFiles.h"
+#include "SimulationParamsStream.h"
+#include "SimulationResult.h"
+#include "SweepJournal.h"
+#include "WorkerProtocol.h"
+
+#include "Logger.h"
+#include "TaskRunner.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <poll.h>
+
+namespace {
+
+using namespace WorkerProtocol;
+
+// How long to wait for a worker before checking the task is still running
+int constexpr POLL_TIMEOUT_MILLISECONDS = 100;
+
+} // namespace
+
+SweepCoordinator::SweepCoordinator(SweepJournal &journal,
+                                   OutFileProcessor &outFileProcessor)
+    : m_journal(journal), m_outFileProcessor(outFileProcessor),
+      m_taskRunner(TaskRunner::getInstance()) {}
+
+SweepCoordinator::~SweepCoordinator() {}
+
+void SweepCoordinator::resetCoordinator(SweepDefinition const &sweep,
+                                        std::size_t numberOfSimulations) {
+  m_queuedRuns.clear();
+  m_connections.clear();
+  m_outFileProcessor.resetResults(sweep);
+
+  m_taskRunner.setTask("Running simulations on workers...", 0.0, 100.0);
+  m_taskRunner.setNumberOfSteps(numberOfSimulations);
+}
+
+bool SweepCoordinator::run(SweepDefinition const &sweep,
+                           std::string const &address) {
+  m_parametersStream = std::make_unique<SimulationParamsStream>(sweep);
+  resetCoordinator(sweep, m_parametersStream->size());
+
+  auto const listener = LineSocket::listen(address);
+  Logger::getInstance().addLog(LogType::Info,
+                               "Waiting for workers at " + address + ".");
+
+  while (m_taskRunner.isRunning() && !isComplete())
+    pollConnections(listener);
+
+  for (auto &connection : m_connections)
+    connection.m_socket.send(doneMessage());
+  m_connections.clear();
+  m_queuedRuns.clear();
+
+  m_outFileProcessor.saveResults();
+  return m_taskRunner.isRunning();
+}
+
+bool SweepCoordinator::hasQueuedRun() {
+  // Runs the journal has settled are restored instead of being queued
+  std::vector<InitSimulationParams> parameters;
+  while (m_queuedRuns.empty() && m_parametersStream->next(parameters, 1)) {
+    if (m_outFileProcessor.restoreOutcomes(parameters.front()))
+      m_taskRunner.reportProgress();
+    else
+      m_queuedRuns.emplace_back(parameters.front());
+  }
+  return !m_queuedRuns.empty();
+}
+
+bool SweepCoordinator::nextRun(InitSimulationParams &parameters) {
+  if (!hasQueuedRun())
+    return false;
+  parameters = m_queuedRuns.front();
+  m_queuedRuns.pop_front();
+  return true;
+}
+
+bool SweepCoordinator::isComplete() {
+  return !hasQueuedRun() &&
+         std::all_of(m_connections.begin(), m_connections.end(),
+                     [](Connection const &connection) {
+                       return connection.m_assignedRuns.empty();
+                     });
+}
+
+void SweepCoordinator::pollConnections(LineSocket const &listener) {
+  std::vector<pollfd> descriptors{{listener.descriptor(), POLLIN, 0}};
+  for (auto const &connection : m_connections)
+    descriptors.push_back({connection.m_socket.descriptor(), POLLIN, 0});
+
+  if (poll(descriptors.data(), descriptors.size(),
+           POLL_TIMEOUT_MILLISECONDS) <= 0)
+    return;
+
+  // Connections accepted below are not in the descriptors until the next poll
+  auto descriptor = descriptors.begin() + 1;
+  for (auto iter = m_connections.begin(); iter != m_connections.end();
+       ++descriptor) {
+    if (descriptor->revents != 0 && !serviceWorker(*iter)) {
+      releaseRuns(*iter);
+      iter = m_connections.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+
+  if (descriptors.front().revents & POLLIN)
+    acceptWorker(listener);
+
+  // Runs released by a worker which disconnected go to whichever workers
+  // have room, even if they are idle
+  for (auto &connection : m_connections)
+    assignRuns(connection);
+}
+
+void SweepCoordinator::acceptWorker(LineSocket const &listener) {
+  auto socket = listener.accept();
+  if (socket.isOpen() && socket.send(settingsMessage()))
+    m_connections.emplace_back(Connection{std::move(socket), 0, {}});
+}
+
+bool SweepCoordinator::serviceWorker(Connection &connection) {
+  if (!connection.m_socket.readAvailable())
+    return false;
+
+  std::string message;
+  while (connection.m_socket.nextLine(message))
+    if (!handleMessage(connection, message))
+      return false;
+  return true;
+}
+
+bool SweepCoordinator::handleMessage(Connection &connection,
+                                     std::string const &message) {
+  std::uint64_t runId;
+  std::vector<RunOutcome> outcomes;
+  std::string reason;
+
+  switch (messageType(message)) {
+  case MessageType::Worker:
+    if (!parseWorker(message, connection.m_capacity))
+      return false;
+    Logger::getInstance().addLog(
+        LogType::Info, "A worker joined, running " +
+                           std::to_string(connection.m_capacity) +
+                           " simulations at once.");
+    break;
+  case MessageType::Outcome:
+    // An outcome is only recorded when it holds one entry for every planet
+    if (!parseOutcome(message, runId, outcomes) ||
+        connection.m_assignedRuns.count(runId) == 0 ||
+        outcomes.size() !=
+            connection.m_assignedRuns.at(runId).m_numberOfPlanets)
+      return false;
+    m_outFileProcessor.recordOutcomes(connection.m_assignedRuns.at(runId),
+                                      outcomes);
+    connection.m_assignedRuns.erase(runId);
+    m_taskRunner.reportProgress();
+    break;
+  case MessageType::Failed:
+    if (!parseFailed(message, runId, reason) ||
+        connection.m_assignedRuns.count(runId) == 0)
+      return false;
+    Logger::getInstance().addLog(
+        LogType::Warning,
+        "The integrator for " +
+            connection.m_assignedRuns.at(runId).filename() + " " + reason +
+            ". The run is recorded as failed.");
+    m_journal.recordFailed(connection.m_assignedRuns.at(runId), reason);
+    connection.m_assignedRuns.erase(runId);
+    m_taskRunner.reportProgress();
+    break;
+  default:
+    return false;
+  }
+  return true;
+}
+
+void SweepCoordinator::assignRuns(Connection &connection) {
+  auto parameters = InitSimulationParams(0, 0.0, 0.0, 0, 0, 0);
+  while (connection.m_assignedRuns.size() < connection.m_capacity &&
+         nextRun(parameters)) {
+    if (!connection.m_socket.send(runMessage(parameters))) {
+      m_queuedRuns.push_front(parameters);
+      return;
+    }
+    connection.m_assignedRuns.emplace(parameters.m_runId, parameters);
+  }
+}
+
+void SweepCoordinator::releaseRuns(Connection &connection) {
+  if (connection.m_capacity > 0)
+    Logger::getInstance().addLog(
+        LogType::Warning,
+        "A worker disconnected. Its " +
+            std::to_string(connection.m_assignedRuns.size()) +
+            " unfinished simulations will be run by the other workers.");
+  for (auto const &run : connection.m_assignedRuns)
+    m_queuedRuns.push_back(run.second);
+  connection.m_assignedRuns.clear();
+}
+
+#endif /* __linux__ */
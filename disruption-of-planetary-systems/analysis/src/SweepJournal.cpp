@@ -0,0 +1,253 @@
+#include "SweepJournal.h"
+#include "InitFileSerializer.h"
+#include "InitSimulationParams.h"
+
+#include "Logger.h"
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+using namespace InitFileSerializer;
+
+// The number of values stored for each planet of an analysed run
+std::size_t constexpr VALUES_PER_OUTCOME = 6;
+
+char const *stateName(RunState state) {
+  switch (state) {
+  case RunState::Generated:
+    return "generated";
+  case RunState::Simulated:
+    return "simulated";
+  case RunState::Analysed:
+    return "analysed";
+  case RunState::Failed:
+    return "failed";
+  default:
+    return "pending";
+  }
+}
+
+RunState parseState(std::string const &name) {
+  for (auto const state :
+       {RunState::Generated, RunState::Simulated, RunState::Analysed,
+        RunState::Failed})
+    if (name == stateName(state))
+      return state;
+  return RunState::Pending;
+}
+
+bool parseValue(std::string const &text, double &value) {
+  auto const end = text.data() + text.size();
+  auto const result = std::from_chars(text.data(), end, value);
+  return result.ec == std::errc() && result.ptr == end;
+}
+
+void synchroniseFile(std::FILE *file) {
+  std::fflush(file);
+#ifdef _WIN32
+  _commit(_fileno(file));
+#else
+  fsync(fileno(file));
+#endif
+}
+
+} // namespace
+
+SweepJournal::SweepJournal(std::string const &directory)
+    : m_filename(directory + "sweep_journal.log"), m_file(nullptr) {}
+
+SweepJournal::~SweepJournal() { close(); }
+
+void SweepJournal::open(bool resume) {
+  close();
+  m_entries.clear();
+
+  if (resume && load()) {
+    m_file = std::fopen(m_filename.c_str(), "ab");
+  } else {
+    if (resume)
+      Logger::getInstance().addLog(
+          LogType::Warning,
+          "No sweep journal was found to resume from. Starting a new sweep.");
+    m_file = std::fopen(m_filename.c_str(), "wb");
+    if (m_file) {
+      std::string header = "seed ";
+      appendNumber(header, static_cast<std::size_t>(
+                               OtherSimulationSettings::m_sweepSeed));
+      header += " bodies ";
+      appendNumber(header, InitHeaderData::numberOfBodies());
+      append(header, true);
+    }
+  }
+
+  if (!m_file)
+    throw std::runtime_error("Failed to open file " + m_filename +
+                             " for writing.");
+}
+
+void SweepJournal::close() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (m_file) {
+    std::fclose(m_file);
+    m_file = nullptr;
+  }
+}
+
+bool SweepJournal::load() {
+  std::ifstream fileStream(m_filename, std::ios::binary);
+  if (!fileStream.is_open())
+    return false;
+  std::string const text((std::istreambuf_iterator<char>(fileStream)),
+                         std::istreambuf_iterator<char>());
+  fileStream.close();
+
+  // Anything after the last line break was cut off while being written
+  auto const lastLineEnd = text.rfind('\n');
+  if (lastLineEnd == std::string::npos)
+    return false;
+  if (lastLineEnd + 1 < text.size())
+    std::filesystem::resize_file(m_filename, lastLineEnd + 1);
+
+  std::istringstream lines(text.substr(0, lastLineEnd));
+  std::string line;
+  std::getline(lines, line);
+  loadHeader(line);
+  while (std::getline(lines, line))
+    loadEntry(line);
+  return true;
+}
+
+void SweepJournal::loadHeader(std::string const &line) {
+  std::istringstream header(line);
+  std::string seedLabel, bodiesLabel;
+  std::uint64_t seed;
+  std::size_t numberOfBodies;
+  if (!(header >> seedLabel >> seed >> bodiesLabel >> numberOfBodies) ||
+      seedLabel != "seed" || bodiesLabel != "bodies")
+    throw std::runtime_error("The sweep journal " + m_filename +
+                             " has an invalid header.");
+
+  if (numberOfBodies != InitHeaderData::numberOfBodies())
+    throw std::runtime_error("The sweep journal was written for a sweep with " +
+                             std::to_string(numberOfBodies) + " bodies.");
+
+  // The orientations of the remaining runs must match those already simulated
+  if (seed != OtherSimulationSettings::m_sweepSeed) {
+    OtherSimulationSettings::m_sweepSeed = seed;
+    Logger::getInstance().addLog(LogType::Info,
+                                 "Resuming the sweep with its seed " +
+                                     std::to_string(seed) + ".");
+  }
+}
+
+void SweepJournal::loadEntry(std::string const &line) {
+  std::istringstream entryStream(line);
+  std::string stateText, filename;
+  if (!(entryStream >> stateText >> filename))
+    return;
+
+  auto const state = parseState(stateText);
+  if (state == RunState::Pending)
+    return;
+
+  std::vector<RunOutcome> outcomes;
+  if (state == RunState::Analysed) {
+    std::vector<double> values;
+    std::string valueText;
+    double value;
+    while (entryStream >> valueText && parseValue(valueText, value))
+      values.emplace_back(value);
+    if (!entryStream.eof() || values.empty() ||
+        values.size() % VALUES_PER_OUTCOME != 0)
+      return;
+
+    for (auto i = 0u; i < values.size(); i += VALUES_PER_OUTCOME)
+      outcomes.emplace_back(RunOutcome{values[i] != 0.0, values[i + 1] != 0.0,
+                                       values[i + 2], values[i + 3],
+                                       values[i + 4], values[i + 5]});
+  }
+
+  auto &entry = m_entries[filename];
+  if (state >= entry.m_state) {
+    entry.m_state = state;
+    if (state == RunState::Analysed)
+      entry.m_outcomes = std::move(outcomes);
+  }
+}
+
+RunState SweepJournal::state(InitSimulationParams const &parameters) const {
+  auto const iter = m_entries.find(parameters.filename());
+  if (iter != m_entries.end())
+    return iter->second.m_state;
+  return RunState::Pending;
+}
+
+std::vector<RunOutcome> const &
+SweepJournal::outcomes(InitSimulationParams const &parameters) const {
+  static std::vector<RunOutcome> const noOutcomes;
+  auto const iter = m_entries.find(parameters.filename());
+  if (iter != m_entries.end())
+    return iter->second.m_outcomes;
+  return noOutcomes;
+}
+
+void SweepJournal::recordGenerated(InitSimulationParams const &parameters) {
+  // A generated run is regenerated on resume, so it does not need to be synced
+  append(std::string(stateName(RunState::Generated)) + " " +
+             parameters.filename(),
+         false);
+}
+
+void SweepJournal::recordSimulated(InitSimulationParams const &parameters) {
+  append(std::string(stateName(RunState::Simulated)) + " " +
+             parameters.filename(),
+         true);
+}
+
+void SweepJournal::recordAnalysed(InitSimulationParams const &parameters,
+                                  std::vector<RunOutcome> const &outcomes) {
+  auto line = std::string(stateName(RunState::Analysed)) + " " +
+              parameters.filename();
+  for (auto const &outcome : outcomes) {
+    line += outcome.m_bhBound ? " 1" : " 0";
+    line += outcome.m_starBound ? " 1" : " 0";
+    for (auto const value :
+         {outcome.m_semiMajorBh, outcome.m_semiMajorStar,
+          outcome.m_eccentricityBh, outcome.m_eccentricityStar}) {
+      line += ' ';
+      appendNumber(line, value);
+    }
+  }
+  append(line, true);
+}
+
+void SweepJournal::recordFailed(InitSimulationParams const &parameters,
+                                std::string const &reason) {
+  append(std::string(stateName(RunState::Failed)) + " " +
+             parameters.filename() + " " + reason,
+         true);
+}
+
+void SweepJournal::append(std::string const &line, bool synchronise) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (!m_file)
+    return;
+
+  std::fputs(line.c_str(), m_file);
+  std::fputc('\n', m_file);
+  if (synchronise)
+    synchroniseFile(m_file);
+}
@@ -0,0 +1,313 @@
+#include "SweepPipeline.h"
+#include "Body.h"
+#include "BodyCreator.h"
+#include "GenerateInitFiles.h"
+#include "NBodyIntegrator.h"
+#include "ProcessOutFiles.h"
+#include "RunCostModel.h"
+#include "SimulationBackend.h"
+#include "SimulationParamsStream.h"
+#include "SweepFiles.h"
+#include "SimulationResult.h"
+#include "SweepJournal.h"
+
+#include "Logger.h"
+#include "PackedFile.h"
+#include "TaskRunner.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+// The number of queued items per integrator between two stages
+std::size_t constexpr QUEUED_PER_INTEGRATOR = 2;
+
+// How often running integrators are polled while waiting for init records
+std::chrono::milliseconds constexpr POLL_INTERVAL(20);
+
+std::size_t numberOfAnalysisThreads() {
+  return std::max(1u, std::thread::hardware_concurrency() / 4);
+}
+
+bool usesBackend(IntegratorBackend backend) {
+  return OtherSimulationSettings::m_integratorBackend == backend;
+}
+
+std::vector<std::unique_ptr<Body>>
+integrateBodies(InitSimulationParams const &parameters) {
+  auto const planetDistance = parameters.largestPlanetDistance();
+  return NBodyIntegrator().integrate(
+      BodyCreator::createBodies(parameters),
+      InitHeaderData::timeStep(parameters.m_pericentre, planetDistance),
+      InitHeaderData::numberOfTimeStep(parameters.m_pericentre,
+                                       planetDistance));
+}
+
+InitSimulationParams emptyParameters() {
+  return InitSimulationParams(0, 0.0, 0.0, 0, 0, 0);
+}
+
+bool fileExists(std::string const &filename) {
+  return std::ifstream(filename).is_open();
+}
+
+} // namespace
+
+SweepPipeline::SweepPipeline(std::string const &directory,
+                             InitFileGenerator &initFileGenerator,
+                             OutFileProcessor &outFileProcessor,
+                             SweepJournal &journal, RunCostModel &costModel)
+    : m_directory(directory), m_initFileGenerator(initFileGenerator),
+      m_outFileProcessor(outFileProcessor), m_journal(journal),
+      m_costModel(costModel), m_taskRunner(TaskRunner::getInstance()),
+      m_comparison(directory) {}
+
+SweepPipeline::~SweepPipeline() {}
+
+void SweepPipeline::resetPipeline(SweepDefinition const &sweep) {
+  auto const capacity =
+      QUEUED_PER_INTEGRATOR * OtherSimulationSettings::numberOfIntegrators();
+  m_initRecords = std::make_unique<BoundedQueue<InitRecord>>(capacity);
+  m_outFiles = std::make_unique<BoundedQueue<InitSimulationParams>>(capacity);
+
+  m_outPack.reset();
+  m_resumedOutPack.reset();
+  if (OtherSimulationSettings::m_usePackedFiles &&
+      !OtherSimulationSettings::m_deleteOutFiles) {
+    // The .out files released before a resume are only found in the pack
+    auto const outPackFilename = m_directory + SweepFiles::OUT_PACK;
+    if (OtherSimulationSettings::m_resumeSweep &&
+        fileExists(PackedFile::indexFilename(outPackFilename)))
+      m_resumedOutPack = std::make_unique<PackedFileReader>(outPackFilename);
+    m_outPack = std::make_unique<PackedFileWriter>(
+        outPackFilename, !OtherSimulationSettings::m_resumeSweep);
+  }
+
+  m_errorMessage.clear();
+  m_outFileProcessor.resetResults(sweep);
+  m_comparison.reset();
+
+  m_taskRunner.setTask("Running simulations...", 0.0, 100.0);
+  m_taskRunner.setNumberOfSteps(sweep.numberOfSimulations());
+}
+
+bool SweepPipeline::run(SweepDefinition const &sweep) {
+  resetPipeline(sweep);
+
+  auto simulated = false;
+  {
+    ThreadPool analysisPool(numberOfAnalysisThreads());
+    for (auto i = 0u; i < numberOfAnalysisThreads(); ++i)
+      analysisPool.addToQueue([this]() { analyseOutFiles(); });
+
+    std::thread generator([&]() { generateInitRecords(sweep); });
+    try {
+      simulated = simulateInitRecords();
+    } catch (std::runtime_error const &error) {
+      stop(error.what());
+    }
+    m_initRecords->close();
+    generator.join();
+    m_outFiles->close();
+  }
+
+  m_outFileProcessor.saveResults();
+  if (usesBackend(IntegratorBackend::Comparison))
+    m_comparison.save();
+  m_outPack.reset();
+  m_resumedOutPack.reset();
+
+  if (!m_errorMessage.empty())
+    throw std::runtime_error(m_errorMessage);
+  return simulated && m_taskRunner.isRunning();
+}
+
+void SweepPipeline::generateInitRecords(SweepDefinition const &sweep) {
+  try {
+    m_initFileGenerator.generate(
+        sweep, [this](InitSimulationParams const &parameters,
+                      std::string &&initRecord) {
+          queueInitRecord(parameters, std::move(initRecord));
+        });
+  } catch (std::runtime_error const &error) {
+    stop(error.what());
+  }
+  m_initRecords->close();
+}
+
+void SweepPipeline::queueInitRecord(InitSimulationParams const &parameters,
+                                    std::string &&initRecord) {
+  auto const state = m_journal.state(parameters);
+  auto const simulated = state == RunState::Simulated &&
+                         !usesBackend(IntegratorBackend::InProcess);
+  if (state >= RunState::Analysed) {
+    m_outFileProcessor.restoreOutcomes(parameters);
+    m_taskRunner.reportProgress();
+  } else if (simulated &&
+             fileExists(m_directory + parameters.filename() + ".out")) {
+    m_outFiles->push(InitSimulationParams(parameters));
+  } else if (simulated && m_resumedOutPack &&
+             m_resumedOutPack->contains(parameters.filename())) {
+    // A packed .out file is analysed from the pack rather than packed again
+    m_outFileProcessor.processOutRecord(
+        parameters, m_resumedOutPack->read(parameters.filename()));
+    m_taskRunner.reportProgress();
+  } else {
+    m_initRecords->push(std::make_pair(parameters, std::move(initRecord)));
+  }
+}
+
+bool SweepPipeline::simulateInitRecords() {
+  if (usesBackend(IntegratorBackend::InProcess))
+    return simulateInProcess();
+  return simulateExternally();
+}
+
+bool SweepPipeline::simulateExternally() {
+  auto const backend = createSimulationBackend(
+      m_directory, OtherSimulationSettings::numberOfIntegrators(),
+      [this](InitSimulationParams const &parameters,
+             std::string const &outFilename, std::string const &failure,
+             double seconds) {
+        collectOutFile(parameters, outFilename, failure, seconds);
+      },
+      [this]() { return m_taskRunner.isRunning(); });
+
+  // Finished integrators are collected, and their limits enforced, while
+  // waiting for the generator
+  InitRecord initRecord(emptyParameters(), std::string());
+  while (!m_initRecords->isDrained()) {
+    if (m_initRecords->popFor(initRecord, POLL_INTERVAL)) {
+      if (!backend->submitRecord(initRecord.first, initRecord.second))
+        return false;
+    } else if (!backend->poll()) {
+      return false;
+    }
+  }
+  return backend->waitForAll();
+}
+
+bool SweepPipeline::simulateInProcess() {
+  {
+    auto const numberOfIntegrators =
+        OtherSimulationSettings::numberOfIntegrators();
+    ThreadPool integratorPool(numberOfIntegrators);
+    for (auto i = 0u; i < numberOfIntegrators; ++i)
+      integratorPool.addToQueue([this]() { integrateInitRecords(); });
+  }
+  return m_taskRunner.isRunning();
+}
+
+void SweepPipeline::integrateInitRecords() {
+  InitRecord initRecord(emptyParameters(), std::string());
+  while (m_taskRunner.isRunning() && m_initRecords->pop(initRecord)) {
+    auto const &parameters = initRecord.first;
+    try {
+      m_outFileProcessor.processTrajectory(parameters,
+                                           integrateBodies(parameters));
+    } catch (std::runtime_error const &error) {
+      Logger::getInstance().addLog(LogType::Warning,
+                                   parameters.filename() + ": " +
+                                       error.what());
+    }
+    m_taskRunner.reportProgress();
+  }
+  // Stops the generator from waiting on integrators which have ended early
+  m_initRecords->close();
+}
+
+void SweepPipeline::collectOutFile(InitSimulationParams const &parameters,
+                                   std::string const &outFilename,
+                                   std::string const &failure,
+                                   double seconds) {
+  auto const filename = parameters.filename();
+  if (!failure.empty()) {
+    Logger::getInstance().addLog(LogType::Warning,
+                                 "The integrator for " + filename + " " +
+                                     failure +
+                                     ". The run is recorded as failed.");
+    m_journal.recordFailed(parameters, failure);
+    std::remove(outFilename.c_str());
+    m_taskRunner.reportProgress();
+    return;
+  }
+
+  // The scratch directory is reused by the next integrator straight away
+  if (std::rename(outFilename.c_str(),
+                  (m_directory + filename + ".out").c_str()) != 0) {
+    Logger::getInstance().addLog(LogType::Warning,
+                                 "Failed to move " + filename + ".out.");
+    m_taskRunner.reportProgress();
+    return;
+  }
+
+  m_journal.recordSimulated(parameters);
+  // The wall times of the mock and replay backends say nothing of the cost of
+  // a real run, so only those of NewARC.out are recorded
+  if (usesBackend(IntegratorBackend::External) ||
+      usesBackend(IntegratorBackend::Comparison))
+    m_costModel.recordRun(parameters, seconds);
+  m_outFiles->push(InitSimulationParams(parameters));
+}
+
+void SweepPipeline::analyseOutFiles() {
+  auto parameters = emptyParameters();
+  while (m_taskRunner.isRunning() && m_outFiles->pop(parameters)) {
+    if (usesBackend(IntegratorBackend::Comparison))
+      compareOutFile(parameters);
+    else
+      m_outFileProcessor.processOutFile(parameters);
+    releaseOutFile(parameters);
+    m_taskRunner.reportProgress();
+  }
+  // Stops the integrators from waiting on an analysis which has ended early
+  m_outFiles->close();
+}
+
+void SweepPipeline::compareOutFile(InitSimulationParams const &parameters) {
+  try {
+    auto const externalBodies = m_outFileProcessor.loadOutFile(parameters);
+    auto const externalOutcomes =
+        m_outFileProcessor.processTrajectory(parameters, externalBodies);
+
+    auto const internalBodies = integrateBodies(parameters);
+    m_comparison.addComparison(
+        parameters, externalBodies, internalBodies, externalOutcomes,
+        m_outFileProcessor.computeOutcomes(internalBodies));
+  } catch (std::runtime_error const &error) {
+    stop(std::string("Comparing integrators failed: ") + error.what());
+  }
+}
+
+void SweepPipeline::releaseOutFile(InitSimulationParams const &parameters) {
+  auto const filename = parameters.filename();
+  auto const outFilename = m_directory + filename + ".out";
+
+  // A .out file which could not be packed is kept on disk
+  if (m_outPack) {
+    try {
+      m_outPack->appendFile(filename, outFilename);
+    } catch (std::runtime_error const &error) {
+      stop(std::string("Packing .out files failed: ") + error.what());
+      return;
+    }
+  }
+  if ((m_outPack || OtherSimulationSettings::m_deleteOutFiles) &&
+      std::remove(outFilename.c_str()) != 0)
+    Logger::getInstance().addLog(LogType::Warning,
+                                 "Failed to delete file " + filename +
+                                     ".out.");
+}
+
+void SweepPipeline::stop(std::string const &errorMessage) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (m_errorMessage.empty())
+    m_errorMessage = errorMessage;
+  m_taskRunner.stopTask();
+}
@@ -0,0 +1,369 @@
+#include "SweepShards.h"
+#include "GenerateInitFiles.h"
+#include "InitFileSerializer.h"
+#include "InitSimulationParams.h"
+#include "ProcessOutFiles.h"
+#include "RunCostModel.h"
+#include "SimulationParamsStream.h"
+#include "SimulationResult.h"
+#include "SweepJournal.h"
+#include "SweepPipeline.h"
+#include "WorkerProtocol.h"
+
+#include "TaskRunner.h"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+using namespace InitFileSerializer;
+using namespace WorkerProtocol;
+
+// The file a shard saves its partial results to
+char constexpr PARTIAL_RESULTS[] = "partial_results.txt";
+
+char constexpr COMBINE[] = "combine";
+char constexpr PERICENTRES[] = "pericentres";
+char constexpr PLANET_DISTANCES_A[] = "planetDistancesA";
+char constexpr PLANET_DISTANCES_B[] = "planetDistancesB";
+char constexpr ORIENTATIONS[] = "orientations";
+char constexpr SHARD[] = "shard";
+char constexpr CELLS[] = "cells";
+char constexpr COUNTS[] = "counts";
+
+// The number of planets, black hole bound and star bound of a cell and planet
+using Counts = std::array<std::size_t, 3>;
+using CellCounts = std::map<std::pair<std::size_t, std::size_t>, Counts>;
+
+/*
+The shared sweep lines of a manifest or partial results file, and the shard
+lines which follow them
+*/
+struct Manifest {
+  std::vector<std::string> m_sweepLines;
+  std::size_t m_shardIndex;
+  std::size_t m_numberOfShards;
+  std::vector<std::size_t> m_cells;
+};
+
+std::string joinValues(std::string const &key,
+                       std::vector<std::string> const &values) {
+  auto line = key;
+  for (auto const &value : values)
+    line += ' ' + value;
+  return line;
+}
+
+std::vector<std::string> splitLine(std::string const &line) {
+  std::istringstream lineStream(line);
+  std::vector<std::string> words;
+  std::string word;
+  while (lineStream >> word)
+    words.emplace_back(word);
+  return words;
+}
+
+std::vector<std::string> sweepLines(SweepDefinition const &sweep) {
+  return {settingsMessage(),
+          std::string(COMBINE) +
+              (OtherSimulationSettings::m_combinePlanetResults ? " 1" : " 0"),
+          joinValues(PERICENTRES, sweep.m_pericentres),
+          joinValues(PLANET_DISTANCES_A, sweep.m_planetDistancesA),
+          joinValues(PLANET_DISTANCES_B, sweep.m_planetDistancesB),
+          std::string(ORIENTATIONS) + ' ' +
+              std::to_string(sweep.m_numberOfOrientations)};
+}
+
+std::string manifestText(Manifest const &manifest) {
+  std::string text;
+  for (auto const &line : manifest.m_sweepLines)
+    text += line + '\n';
+  text += std::string(SHARD) + ' ' + std::to_string(manifest.m_shardIndex) +
+          ' ' + std::to_string(manifest.m_numberOfShards) + '\n';
+  text += CELLS;
+  for (auto const cell : manifest.m_cells)
+    text += ' ' + std::to_string(cell);
+  return text + '\n';
+}
+
+// Reads the manifest lines, leaving the stream at the lines which follow
+Manifest readManifest(std::istream &fileStream, std::string const &filename) {
+  Manifest manifest;
+  std::string line;
+  while (manifest.m_sweepLines.size() < 6 && std::getline(fileStream, line))
+    manifest.m_sweepLines.emplace_back(line);
+
+  std::vector<std::string> words;
+  if (std::getline(fileStream, line))
+    words = splitLine(line);
+  if (manifest.m_sweepLines.size() < 6 || words.size() != 3 ||
+      words[0] != SHARD)
+    throw std::runtime_error(filename + " is not a shard of a sweep.");
+  manifest.m_shardIndex = std::stoul(words[1]);
+  manifest.m_numberOfShards = std::stoul(words[2]);
+  if (manifest.m_shardIndex < 1 ||
+      manifest.m_shardIndex > manifest.m_numberOfShards)
+    throw std::runtime_error(filename + " has an invalid shard index.");
+
+  if (!std::getline(fileStream, line) ||
+      (words = splitLine(line)).empty() || words[0] != CELLS)
+    throw std::runtime_error(filename + " does not list the cells of its "
+                                        "shard.");
+  for (auto i = 1u; i < words.size(); ++i)
+    manifest.m_cells.emplace_back(std::stoul(words[i]));
+  return manifest;
+}
+
+Manifest loadManifest(std::string const &filename) {
+  std::ifstream fileStream(filename);
+  if (!fileStream.is_open())
+    throw std::runtime_error("Failed to open file " + filename + ".");
+  return readManifest(fileStream, filename);
+}
+
+std::vector<std::string> sweepValues(std::string const &line,
+                                     std::string const &key) {
+  auto words = splitLine(line);
+  if (words.empty() || words[0] != key)
+    throw std::runtime_error("The sweep has no " + key + ".");
+  words.erase(words.begin());
+  return words;
+}
+
+// Applies the settings of the sweep and recreates its definition
+std::unique_ptr<SweepDefinition> createSweep(Manifest const &manifest) {
+  auto const &lines = manifest.m_sweepLines;
+  if (!applySettings(lines[0]))
+    throw std::runtime_error("The settings of the sweep are invalid.");
+  OtherSimulationSettings::m_combinePlanetResults =
+      sweepValues(lines[1], COMBINE) == std::vector<std::string>{"1"};
+
+  auto const orientations = sweepValues(lines[5], ORIENTATIONS);
+  if (orientations.size() != 1)
+    throw std::runtime_error("The sweep has no number of orientations.");
+  return std::make_unique<SweepDefinition>(
+      sweepValues(lines[2], PERICENTRES),
+      sweepValues(lines[3], PLANET_DISTANCES_A),
+      sweepValues(lines[4], PLANET_DISTANCES_B), std::stoul(orientations[0]));
+}
+
+void addCounts(CellCounts &cellCounts, std::size_t cell,
+               std::vector<RunOutcome> const &outcomes) {
+  for (auto i = 0u; i < outcomes.size(); ++i) {
+    auto &counts = cellCounts[std::make_pair(cell, i)];
+    ++counts[0];
+    if (outcomes[i].m_bhBound)
+      ++counts[1];
+    else if (outcomes[i].m_starBound)
+      ++counts[2];
+  }
+}
+
+std::string partialResultsText(Manifest const &manifest,
+                               SweepDefinition const &sweep,
+                               SweepJournal const &journal) {
+  CellCounts cellCounts;
+  std::string runLines;
+
+  SimulationParamsStream parametersStream(sweep);
+  std::vector<InitSimulationParams> parameters;
+  while (parametersStream.next(parameters, 1)) {
+    auto const &run = parameters.front();
+    auto const state = journal.state(run);
+    if (state == RunState::Analysed) {
+      auto const &outcomes = journal.outcomes(run);
+      addCounts(cellCounts, run.m_runId / sweep.m_numberOfOrientations,
+                outcomes);
+      runLines += outcomeMessage(run.m_runId, outcomes) + '\n';
+    } else if (state == RunState::Failed) {
+      runLines += failedMessage(run.m_runId, "on every attempt") + '\n';
+    } else {
+      throw std::runtime_error("The shard has not finished " +
+                               run.filename() + ".");
+    }
+  }
+
+  auto text = manifestText(manifest);
+  for (auto const &counts : cellCounts)
+    text += std::string(COUNTS) + ' ' + std::to_string(counts.first.first) +
+            ' ' + std::to_string(counts.first.second) + ' ' +
+            std::to_string(counts.second[0]) + ' ' +
+            std::to_string(counts.second[1]) + ' ' +
+            std::to_string(counts.second[2]) + '\n';
+  return text + runLines;
+}
+
+/*
+The outcomes gathered from the partial results of every shard
+*/
+struct MergedRuns {
+  std::unique_ptr<Manifest> m_manifest;
+  std::set<std::size_t> m_shards;
+  std::map<std::uint64_t, std::vector<RunOutcome>> m_outcomes;
+  std::set<std::uint64_t> m_failedRuns;
+};
+
+void readPartialResults(std::string const &filename, MergedRuns &mergedRuns) {
+  std::ifstream fileStream(filename);
+  if (!fileStream.is_open())
+    throw std::runtime_error("Failed to open file " + filename + ".");
+  auto const manifest = readManifest(fileStream, filename);
+
+  if (!mergedRuns.m_manifest)
+    mergedRuns.m_manifest = std::make_unique<Manifest>(manifest);
+  else if (manifest.m_sweepLines != mergedRuns.m_manifest->m_sweepLines ||
+           manifest.m_numberOfShards !=
+               mergedRuns.m_manifest->m_numberOfShards)
+    throw std::runtime_error(filename + " belongs to a different sweep.");
+  if (!mergedRuns.m_shards.insert(manifest.m_shardIndex).second)
+    throw std::runtime_error(filename + " repeats shard " +
+                             std::to_string(manifest.m_shardIndex) + ".");
+
+  auto const numberOfOrientations =
+      std::stoul(sweepValues(manifest.m_sweepLines[5], ORIENTATIONS).at(0));
+  CellCounts expectedCounts, cellCounts;
+  std::string line;
+  while (std::getline(fileStream, line)) {
+    std::uint64_t runId;
+    std::vector<RunOutcome> outcomes;
+    std::string reason;
+    auto const words = splitLine(line);
+    if (!words.empty() && words[0] == COUNTS && words.size() == 6) {
+      expectedCounts[std::make_pair(std::stoul(words[1]),
+                                    std::stoul(words[2]))] = {
+          std::stoul(words[3]), std::stoul(words[4]), std::stoul(words[5])};
+    } else if (parseOutcome(line, runId, outcomes)) {
+      addCounts(cellCounts, runId / numberOfOrientations, outcomes);
+      if (!mergedRuns.m_outcomes.emplace(runId, std::move(outcomes)).second)
+        throw std::runtime_error(filename + " repeats run " +
+                                 std::to_string(runId) + ".");
+    } else if (parseFailed(line, runId, reason)) {
+      mergedRuns.m_failedRuns.insert(runId);
+    } else if (!words.empty()) {
+      throw std::runtime_error(filename + " has an invalid line: " + line);
+    }
+  }
+
+  if (cellCounts != expectedCounts)
+    throw std::runtime_error("The counts in " + filename +
+                             " do not match its runs.");
+}
+
+} // namespace
+
+namespace SweepShards {
+
+void writeManifests(SweepDefinition const &sweep, RunCostModel const &costModel,
+                    std::size_t numberOfShards, std::string const &directory) {
+  std::vector<Manifest> manifests(numberOfShards);
+  for (auto i = 0u; i < numberOfShards; ++i)
+    manifests[i] = Manifest{sweepLines(sweep), i + 1, numberOfShards, {}};
+
+  // Each cell, most expensive first, goes to the shard with the least work
+  std::vector<std::size_t> cells(sweep.numberOfCells());
+  std::vector<double> costs(cells.size());
+  for (auto i = 0u; i < cells.size(); ++i) {
+    cells[i] = i;
+    costs[i] = sweep.predictedCellCost(costModel, i);
+  }
+  std::stable_sort(cells.begin(), cells.end(),
+                   [&costs](std::size_t cellA, std::size_t cellB) {
+                     return costs[cellA] > costs[cellB];
+                   });
+
+  std::vector<double> shardCosts(numberOfShards, 0.0);
+  for (auto const cell : cells) {
+    auto const shard =
+        std::min_element(shardCosts.begin(), shardCosts.end()) -
+        shardCosts.begin();
+    shardCosts[shard] += costs[cell];
+    manifests[shard].m_cells.emplace_back(cell);
+  }
+
+  for (auto const &manifest : manifests) {
+    auto const filename = directory + "shard_" +
+                          std::to_string(manifest.m_shardIndex) + ".manifest";
+    std::ofstream fileStream(filename);
+    if (!(fileStream << manifestText(manifest)))
+      throw std::runtime_error("Failed to write file " + filename + ".");
+  }
+}
+
+bool runShard(std::string const &manifestFilename,
+              std::string const &directory) {
+  auto const manifest = loadManifest(manifestFilename);
+  auto const sweep = createSweep(manifest);
+  sweep->selectCells(manifest.m_cells);
+
+  SweepJournal journal(directory);
+  RunCostModel costModel(directory);
+  InitFileGenerator initFileGenerator(directory, journal);
+  OutFileProcessor outFileProcessor(directory, journal);
+  SweepPipeline pipeline(directory, initFileGenerator, outFileProcessor,
+                         journal, costModel);
+
+  // A batch job which is restarted carries on from where it stopped
+  OtherSimulationSettings::m_resumeSweep = true;
+  journal.open(true);
+  costModel.load();
+  sweep->orderCellsByCost(costModel);
+  // Without the interface nothing else starts the task the stages check
+  TaskRunner::getInstance().startTask();
+  auto const complete = pipeline.run(*sweep);
+  journal.close();
+  costModel.save();
+  if (!complete)
+    return false;
+
+  // Reloads the journal to collect the outcomes of the shard
+  journal.open(true);
+  journal.close();
+  auto const filename = directory + PARTIAL_RESULTS;
+  std::ofstream fileStream(filename);
+  if (!(fileStream << partialResultsText(manifest, *sweep, journal)))
+    throw std::runtime_error("Failed to write file " + filename + ".");
+  return true;
+}
+
+void mergeShards(std::vector<std::string> const &partialResultsFilenames,
+                 std::string const &directory) {
+  MergedRuns mergedRuns;
+  for (auto const &filename : partialResultsFilenames)
+    readPartialResults(filename, mergedRuns);
+  if (!mergedRuns.m_manifest ||
+      mergedRuns.m_shards.size() != mergedRuns.m_manifest->m_numberOfShards)
+    throw std::runtime_error(
+        "The partial results of every shard are needed to merge a sweep.");
+
+  // The outcomes are replayed in run ID order through an unopened journal
+  auto const sweep = createSweep(*mergedRuns.m_manifest);
+  SweepJournal journal(directory);
+  OutFileProcessor outFileProcessor(directory, journal);
+  outFileProcessor.resetResults(*sweep);
+
+  SimulationParamsStream parametersStream(*sweep);
+  std::vector<InitSimulationParams> parameters;
+  while (parametersStream.next(parameters, 1)) {
+    auto const &run = parameters.front();
+    auto const iter = mergedRuns.m_outcomes.find(run.m_runId);
+    if (iter != mergedRuns.m_outcomes.end() &&
+        iter->second.size() != run.m_numberOfPlanets)
+      throw std::runtime_error("The outcomes of " + run.filename() +
+                               " do not match its number of planets.");
+    if (iter != mergedRuns.m_outcomes.end())
+      outFileProcessor.recordOutcomes(run, iter->second);
+    else if (mergedRuns.m_failedRuns.count(run.m_runId) == 0)
+      throw std::runtime_error("No shard has the outcomes of " +
+                               run.filename() + ".");
+  }
+  outFileProcessor.saveResults();
+}
+
+} // namespace SweepShards
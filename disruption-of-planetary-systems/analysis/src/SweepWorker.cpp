@@ -0,0 +1,173 @@
+#include "SweepWorker.h"
+
+#ifdef __linux__
+
+#include "Body.h"
+#include "BodyCreator.h"
+#include "InitFileSerializer.h"
+#include "NBodyIntegrator.h"
+#include "SimulationBackend.h"
+#include "SimulationResult.h"
+#include "WorkerProtocol.h"
+
+#include "ThreadPool.h"
+
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+using namespace WorkerProtocol;
+
+// How long to wait for a run before checking on the integrators
+std::chrono::milliseconds constexpr POLL_INTERVAL(20);
+
+InitSimulationParams emptyParameters() {
+  return InitSimulationParams(0, 0.0, 0.0, 0, 0, 0);
+}
+
+} // namespace
+
+SweepWorker::SweepWorker(std::string const &directory)
+    : m_directory(directory), m_journal(directory),
+      m_outFileProcessor(directory, m_journal) {}
+
+SweepWorker::~SweepWorker() {}
+
+void SweepWorker::run(std::string const &address,
+                      std::size_t numberOfIntegrators) {
+  m_socket = LineSocket::connect(address);
+
+  std::string message;
+  if (!m_socket.receive(message) || !applySettings(message))
+    throw std::runtime_error("The coordinator at " + address +
+                             " did not send its settings.");
+
+  OtherSimulationSettings::m_numberOfIntegrators = numberOfIntegrators;
+  auto const capacity = OtherSimulationSettings::numberOfIntegrators();
+  m_runs = std::make_unique<BoundedQueue<InitSimulationParams>>(capacity);
+  send(workerMessage(capacity));
+
+  std::thread receiver([this]() { receiveRuns(); });
+  try {
+    simulateRuns();
+  } catch (std::runtime_error const &) {
+    m_socket.shutdown();
+    receiver.join();
+    throw;
+  }
+  receiver.join();
+  m_socket.close();
+}
+
+void SweepWorker::receiveRuns() {
+  std::string message;
+  auto parameters = emptyParameters();
+  while (m_socket.receive(message) &&
+         messageType(message) == MessageType::Run &&
+         parseRun(message, parameters))
+    m_runs->push(InitSimulationParams(parameters));
+  // The coordinator said done or went away
+  m_runs->close();
+}
+
+void SweepWorker::simulateRuns() {
+  if (OtherSimulationSettings::m_integratorBackend ==
+      IntegratorBackend::InProcess)
+    simulateInProcess();
+  else
+    simulateExternally();
+}
+
+void SweepWorker::simulateExternally() {
+  auto const backend = createSimulationBackend(
+      m_directory, OtherSimulationSettings::numberOfIntegrators(),
+      [this](InitSimulationParams const &parameters,
+             std::string const &outFilename, std::string const &failure,
+             double) { collectOutFile(parameters, outFilename, failure); },
+      []() { return true; });
+
+  // Runs arrive one at a time, so finished integrators are collected while
+  // waiting for the next
+  std::string initRecord;
+  auto parameters = emptyParameters();
+  while (!m_runs->isDrained()) {
+    if (m_runs->popFor(parameters, POLL_INTERVAL)) {
+      initRecord.clear();
+      InitFileSerializer::serializeInitRecord(initRecord, parameters);
+      backend->submitRecord(parameters, initRecord);
+    } else {
+      backend->poll();
+    }
+  }
+  backend->waitForAll();
+}
+
+void SweepWorker::simulateInProcess() {
+  auto const numberOfIntegrators =
+      OtherSimulationSettings::numberOfIntegrators();
+  ThreadPool integratorPool(numberOfIntegrators);
+  for (auto i = 0u; i < numberOfIntegrators; ++i)
+    integratorPool.addToQueue([this]() { integrateRuns(); });
+}
+
+void SweepWorker::integrateRuns() {
+  auto parameters = emptyParameters();
+  while (m_runs->pop(parameters)) {
+    auto const planetDistance = parameters.largestPlanetDistance();
+    try {
+      sendOutcomes(parameters,
+                   NBodyIntegrator().integrate(
+                       BodyCreator::createBodies(parameters),
+                       InitHeaderData::timeStep(parameters.m_pericentre,
+                                                planetDistance),
+                       InitHeaderData::numberOfTimeStep(
+                           parameters.m_pericentre, planetDistance)));
+    } catch (std::runtime_error const &error) {
+      send(failedMessage(parameters.m_runId, error.what()));
+    }
+  }
+}
+
+void SweepWorker::collectOutFile(InitSimulationParams const &parameters,
+                                 std::string const &outFilename,
+                                 std::string const &failure) {
+  auto const filename = m_directory + parameters.filename() + ".out";
+  if (!failure.empty()) {
+    send(failedMessage(parameters.m_runId, failure));
+    std::remove(outFilename.c_str());
+    return;
+  }
+
+  // The scratch directory is reused by the next integrator straight away
+  if (std::rename(outFilename.c_str(), filename.c_str()) != 0) {
+    send(failedMessage(parameters.m_runId, "wrote an .out file which could "
+                                           "not be moved"));
+    return;
+  }
+
+  try {
+    send(outcomeMessage(parameters.m_runId,
+                        m_outFileProcessor.streamOutcomes(parameters)));
+  } catch (std::runtime_error const &error) {
+    send(failedMessage(parameters.m_runId, error.what()));
+  }
+  std::remove(filename.c_str());
+}
+
+void SweepWorker::sendOutcomes(
+    InitSimulationParams const &parameters,
+    std::vector<std::unique_ptr<Body>> const &bodies) {
+  send(outcomeMessage(parameters.m_runId,
+                      m_outFileProcessor.computeOutcomes(bodies)));
+}
+
+void SweepWorker::send(std::string const &message) {
+  // A lost coordinator is noticed by the receiver, which stops the runs
+  std::unique_lock<std::mutex> lock(m_mutex);
+  (void)m_socket.send(message);
+}
+
+#endif /* __linux__ */
@@ -0,0 +1,135 @@
+#include "SyntheticBackend.h"
+
+#include <chrono>
+#include <filesystem>
+#include <stdexcept>
+
+namespace {
+
+// How often the keep running check is made while waiting for a worker
+std::chrono::milliseconds constexpr POLL_INTERVAL(20);
+
+void createDirectory(std::string const &directory) {
+  std::error_code error;
+  std::filesystem::create_directories(directory, error);
+  if (error)
+    throw std::runtime_error("Failed to create directory " + directory + ": " +
+                             error.message());
+}
+
+} // namespace
+
+OutFileSource::~OutFileSource() {}
+
+SyntheticBackend::SyntheticBackend(std::string const &directory,
+                                   std::size_t numberOfWorkers,
+                                   std::unique_ptr<OutFileSource> source,
+                                   CompletionHandler const &completionHandler,
+                                   std::function<bool()> const &keepRunning)
+    : m_directory(directory), m_source(std::move(source)),
+      m_completionHandler(completionHandler), m_keepRunning(keepRunning),
+      m_runs(numberOfWorkers), m_running(0) {
+  for (auto i = 0u; i < numberOfWorkers; ++i) {
+    m_scratchDirectories.emplace_back(m_directory + "scratch/worker" +
+                                      std::to_string(i) + "/");
+    createDirectory(m_scratchDirectories.back());
+  }
+  for (auto const &scratchDirectory : m_scratchDirectories)
+    m_workers.emplace_back([this, scratchDirectory]() {
+      runWorker(scratchDirectory);
+    });
+}
+
+SyntheticBackend::~SyntheticBackend() {
+  m_runs.close();
+  for (auto &worker : m_workers)
+    worker.join();
+
+  std::error_code error;
+  std::filesystem::remove_all(m_directory + "scratch", error);
+}
+
+std::size_t SyntheticBackend::numberOfWorkers() const {
+  return m_scratchDirectories.size();
+}
+
+bool SyntheticBackend::submitFile(InitSimulationParams const &parameters,
+                                  std::string const &) {
+  return submit(parameters);
+}
+
+bool SyntheticBackend::submitRecord(InitSimulationParams const &parameters,
+                                    std::string const &) {
+  return submit(parameters);
+}
+
+bool SyntheticBackend::poll() {
+  if (!m_keepRunning())
+    return false;
+  collectCompletions();
+  return true;
+}
+
+bool SyntheticBackend::waitForAll() { return waitForCompletions(0); }
+
+bool SyntheticBackend::submit(InitSimulationParams const &parameters) {
+  if (!waitForCompletions(numberOfWorkers() - 1))
+    return false;
+
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    ++m_running;
+  }
+  m_runs.push(InitSimulationParams(parameters));
+  return true;
+}
+
+bool SyntheticBackend::waitForCompletions(std::size_t maximumRunning) {
+  while (true) {
+    collectCompletions();
+    if (!m_keepRunning())
+      return false;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_running <= maximumRunning)
+      return true;
+    m_completed.wait_for(lock, POLL_INTERVAL,
+                         [this]() { return !m_completions.empty(); });
+  }
+}
+
+void SyntheticBackend::collectCompletions() {
+  std::deque<Completion> completions;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    completions.swap(m_completions);
+    m_running -= completions.size();
+  }
+  for (auto const &completion : completions)
+    m_completionHandler(completion.m_parameters, completion.m_outFilename,
+                        completion.m_failure, completion.m_seconds);
+}
+
+void SyntheticBackend::runWorker(std::string const &scratchDirectory) {
+  auto parameters = InitSimulationParams(0, 0.0, 0.0, 0, 0, 0);
+  while (m_runs.pop(parameters)) {
+    auto const outFilename =
+        scratchDirectory + parameters.filename() + ".out";
+    auto const startTime = std::chrono::steady_clock::now();
+
+    std::string failure;
+    try {
+      m_source->writeOutFile(parameters, outFilename);
+    } catch (std::runtime_error const &error) {
+      failure = error.what();
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_completions.push_back(Completion{
+        parameters, outFilename, failure,
+        std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                      startTime)
+            .count()});
+    m_completed.notify_one();
+  }
+}
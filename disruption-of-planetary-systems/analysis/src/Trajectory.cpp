@@ -0,0 +1,54 @@
+#include "Trajectory.h"
+#include "XYZComponents.h"
+
+Trajectory::Trajectory() {}
+
+Trajectory::~Trajectory() {}
+
+void Trajectory::reserve(std::size_t numberOfTimeSteps) {
+  for (auto &values : m_components)
+    values.reserve(numberOfTimeSteps);
+}
+
+void Trajectory::append(XYZComponents const &position,
+                        XYZComponents const &velocity) {
+  double const state[] = {position.compX(), position.compY(),
+                          position.compZ(), velocity.compX(),
+                          velocity.compY(), velocity.compZ()};
+  append(state);
+}
+
+// The state holds the position followed by the velocity
+void Trajectory::append(double const *state) {
+  for (auto i = 0u; i < m_components.size(); ++i)
+    m_components[i].emplace_back(state[i]);
+}
+
+std::size_t Trajectory::size() const { return m_components[X].size(); }
+
+ComponentSpan Trajectory::x() const { return component(X); }
+
+ComponentSpan Trajectory::y() const { return component(Y); }
+
+ComponentSpan Trajectory::z() const { return component(Z); }
+
+ComponentSpan Trajectory::vx() const { return component(VX); }
+
+ComponentSpan Trajectory::vy() const { return component(VY); }
+
+ComponentSpan Trajectory::vz() const { return component(VZ); }
+
+XYZComponents Trajectory::position(std::size_t index) const {
+  return XYZComponents(m_components[X][index], m_components[Y][index],
+                       m_components[Z][index]);
+}
+
+XYZComponents Trajectory::velocity(std::size_t index) const {
+  return XYZComponents(m_components[VX][index], m_components[VY][index],
+                       m_components[VZ][index]);
+}
+
+ComponentSpan Trajectory::component(Component component) const {
+  auto const &values = m_components[component];
+  return ComponentSpan(values.data(), values.size());
+}
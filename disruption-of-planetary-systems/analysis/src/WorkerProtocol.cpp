@@ -0,0 +1,306 @@
+#include "WorkerProtocol.h"
+#include "InitFileSerializer.h"
+#include "InitSimulationParams.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+using namespace InitFileSerializer;
+
+// The number of values sent for each planet of a run
+std::size_t constexpr VALUES_PER_OUTCOME = 6;
+
+// The number of words of the settings before the replay directory, which
+// takes the rest of the line so that it may contain spaces
+std::size_t constexpr SETTINGS_WORDS = 19;
+
+char constexpr SETTINGS[] = "settings";
+char constexpr WORKER[] = "worker";
+char constexpr RUN[] = "run";
+char constexpr OUTCOME[] = "outcome";
+char constexpr FAILED[] = "failed";
+char constexpr DONE[] = "done";
+
+std::vector<std::string> splitMessage(std::string const &message) {
+  std::istringstream messageStream(message);
+  std::vector<std::string> words;
+  std::string word;
+  while (messageStream >> word)
+    words.emplace_back(word);
+  return words;
+}
+
+// Splits the leading words off a message, leaving the rest of it in remainder
+std::vector<std::string> splitMessage(std::string const &message,
+                                      std::size_t numberOfWords,
+                                      std::string &remainder) {
+  std::vector<std::string> words;
+  std::size_t position = 0;
+  while (words.size() < numberOfWords && position < message.size()) {
+    auto const end = std::min(message.find(' ', position), message.size());
+    words.emplace_back(message.substr(position, end - position));
+    position = end + 1;
+  }
+  remainder = position < message.size() ? message.substr(position) : "";
+  return words;
+}
+
+template <typename Number>
+bool parseNumber(std::string const &text, Number &value) {
+  auto const end = text.data() + text.size();
+  auto const result = std::from_chars(text.data(), end, value);
+  return result.ec == std::errc() && result.ptr == end;
+}
+
+template <typename Number>
+bool parseNumbers(std::vector<std::string> const &words, std::size_t first,
+                  std::vector<Number> &values) {
+  values.resize(words.size() - first);
+  for (auto i = first; i < words.size(); ++i)
+    if (!parseNumber(words[i], values[i - first]))
+      return false;
+  return true;
+}
+
+// A count sent as a double, which must be a whole non-negative number
+std::size_t countSetting(double value, char const *name) {
+  if (!(value >= 0.0) || std::floor(value) != value)
+    throw std::runtime_error(std::string("Received an invalid ") + name +
+                             " setting.");
+  return static_cast<std::size_t>(value);
+}
+
+// An enum sent as a double, which must name one of its values up to last
+template <typename Enum>
+Enum enumSetting(double value, Enum last, char const *name) {
+  if (countSetting(value, name) > static_cast<std::size_t>(last))
+    throw std::runtime_error(std::string("Received an invalid ") + name +
+                             " setting.");
+  return static_cast<Enum>(value);
+}
+
+void appendValues(std::string &message, std::vector<double> const &values) {
+  for (auto const value : values) {
+    message += ' ';
+    appendNumber(message, value);
+  }
+}
+
+} // namespace
+
+namespace WorkerProtocol {
+
+MessageType messageType(std::string const &message) {
+  auto const type = message.substr(0, message.find(' '));
+  if (type == SETTINGS)
+    return MessageType::Settings;
+  if (type == WORKER)
+    return MessageType::Worker;
+  if (type == RUN)
+    return MessageType::Run;
+  if (type == OUTCOME)
+    return MessageType::Outcome;
+  if (type == FAILED)
+    return MessageType::Failed;
+  if (type == DONE)
+    return MessageType::Done;
+  return MessageType::Unknown;
+}
+
+std::string settingsMessage() {
+  auto const &header = *InitHeaderData::m_fixedHeaderParams;
+  std::string message = SETTINGS;
+  message += ' ';
+  appendNumber(message,
+               static_cast<std::size_t>(OtherSimulationSettings::m_sweepSeed));
+  appendValues(
+      message,
+      {static_cast<double>(header.m_numberOfBodies),
+       OtherSimulationSettings::m_useDefaults ? 1.0 : 0.0, header.m_timeStep,
+       static_cast<double>(header.m_numberOfTimeSteps), header.m_trueAnomaly,
+       static_cast<double>(OtherSimulationSettings::m_integratorBackend),
+       static_cast<double>(OtherSimulationSettings::m_earlyTerminationWindow),
+       static_cast<double>(OtherSimulationSettings::m_wallTimeLimit),
+       static_cast<double>(OtherSimulationSettings::m_cpuTimeLimit),
+       static_cast<double>(OtherSimulationSettings::m_memoryLimit),
+       static_cast<double>(OtherSimulationSettings::m_stallTimeLimit),
+       static_cast<double>(OtherSimulationSettings::m_maximumRetries),
+       static_cast<double>(OtherSimulationSettings::m_mockTimeSteps),
+       static_cast<double>(OtherSimulationSettings::m_mockLatency),
+       OtherSimulationSettings::m_writeOrbitalElements ? 1.0 : 0.0,
+       static_cast<double>(OtherSimulationSettings::m_bootstrapResamples),
+       static_cast<double>(OtherSimulationSettings::m_resultsFormat)});
+  message += ' ' + OtherSimulationSettings::m_replayDirectory;
+  return message;
+}
+
+bool applySettings(std::string const &message) {
+  std::uint64_t seed;
+  std::vector<double> values;
+  std::string replayDirectory;
+  auto const words = splitMessage(message, SETTINGS_WORDS, replayDirectory);
+  if (words.size() != SETTINGS_WORDS || words[0] != SETTINGS ||
+      !parseNumber(words[1], seed) || !parseNumbers(words, 2, values))
+    return false;
+
+  // Every value is checked before any is applied
+  auto const numberOfBodies = countSetting(values[0], "number of bodies");
+  if (numberOfBodies != 3 && numberOfBodies != 4)
+    throw std::runtime_error("Received an invalid number of bodies setting.");
+  auto const numberOfTimeSteps =
+      countSetting(values[3], "number of time steps");
+  auto const integratorBackend =
+      enumSetting(values[5], IntegratorBackend::Replay, "integrator backend");
+  auto const earlyTerminationWindow =
+      countSetting(values[6], "early termination window");
+  auto const wallTimeLimit = countSetting(values[7], "wall-clock limit");
+  auto const cpuTimeLimit = countSetting(values[8], "CPU time limit");
+  auto const memoryLimit = countSetting(values[9], "memory limit");
+  auto const stallTimeLimit = countSetting(values[10], "stall limit");
+  auto const maximumRetries = countSetting(values[11], "maximum retries");
+  auto const mockTimeSteps = countSetting(values[12], "mock time steps");
+  auto const mockLatency = countSetting(values[13], "mock latency");
+  auto const bootstrapResamples =
+      countSetting(values[15], "bootstrap resamples");
+  auto const resultsFormat =
+      enumSetting(values[16], ResultsFormat::Binary, "results format");
+
+  auto &header = *InitHeaderData::m_fixedHeaderParams;
+  OtherSimulationSettings::m_sweepSeed = seed;
+  header.m_numberOfBodies = numberOfBodies;
+  OtherSimulationSettings::m_hasSinglePlanet = header.m_numberOfBodies == 3;
+  OtherSimulationSettings::m_useDefaults = values[1] != 0.0;
+  header.m_timeStep = values[2];
+  header.m_numberOfTimeSteps = numberOfTimeSteps;
+  header.m_trueAnomaly = values[4];
+  OtherSimulationSettings::m_integratorBackend = integratorBackend;
+  OtherSimulationSettings::m_earlyTerminationWindow = earlyTerminationWindow;
+  OtherSimulationSettings::m_wallTimeLimit = wallTimeLimit;
+  OtherSimulationSettings::m_cpuTimeLimit = cpuTimeLimit;
+  OtherSimulationSettings::m_memoryLimit = memoryLimit;
+  OtherSimulationSettings::m_stallTimeLimit = stallTimeLimit;
+  OtherSimulationSettings::m_maximumRetries = maximumRetries;
+  OtherSimulationSettings::m_mockTimeSteps = mockTimeSteps;
+  OtherSimulationSettings::m_mockLatency = mockLatency;
+  OtherSimulationSettings::m_writeOrbitalElements = values[14] != 0.0;
+  OtherSimulationSettings::m_bootstrapResamples = bootstrapResamples;
+  OtherSimulationSettings::m_resultsFormat = resultsFormat;
+  OtherSimulationSettings::m_replayDirectory = replayDirectory;
+  return true;
+}
+
+std::string workerMessage(std::size_t capacity) {
+  std::string message = WORKER;
+  message += ' ';
+  appendNumber(message, capacity);
+  return message;
+}
+
+bool parseWorker(std::string const &message, std::size_t &capacity) {
+  auto const words = splitMessage(message);
+  return words.size() == 2 && words[0] == WORKER &&
+         parseNumber(words[1], capacity) && capacity > 0;
+}
+
+std::string runMessage(InitSimulationParams const &parameters) {
+  std::string message = RUN;
+  message += ' ';
+  appendNumber(message, static_cast<std::size_t>(parameters.m_runId));
+  appendValues(message,
+               {parameters.m_pericentre, parameters.m_planetDistances[0],
+                parameters.m_planetDistances[1]});
+  for (auto const value :
+       {static_cast<std::size_t>(parameters.m_numberOfPlanets),
+        static_cast<std::size_t>(parameters.m_orientationIndex),
+        static_cast<std::size_t>(parameters.m_phi),
+        static_cast<std::size_t>(parameters.m_inclination)}) {
+    message += ' ';
+    appendNumber(message, value);
+  }
+  return message;
+}
+
+bool parseRun(std::string const &message, InitSimulationParams &parameters) {
+  auto const words = splitMessage(message);
+  std::uint64_t runId;
+  double pericentre, planetDistanceA, planetDistanceB;
+  std::size_t numberOfPlanets, orientationIndex, phi, inclination;
+  if (words.size() != 9 || words[0] != RUN || !parseNumber(words[1], runId) ||
+      !parseNumber(words[2], pericentre) ||
+      !parseNumber(words[3], planetDistanceA) ||
+      !parseNumber(words[4], planetDistanceB) ||
+      !parseNumber(words[5], numberOfPlanets) ||
+      !parseNumber(words[6], orientationIndex) ||
+      !parseNumber(words[7], phi) || !parseNumber(words[8], inclination))
+    return false;
+
+  if (numberOfPlanets == 1)
+    parameters = InitSimulationParams(runId, pericentre, planetDistanceA,
+                                      orientationIndex, phi, inclination);
+  else
+    parameters = InitSimulationParams(runId, pericentre, planetDistanceA,
+                                      planetDistanceB, orientationIndex, phi,
+                                      inclination);
+  return true;
+}
+
+std::string outcomeMessage(std::uint64_t runId,
+                           std::vector<RunOutcome> const &outcomes) {
+  std::string message = OUTCOME;
+  message += ' ';
+  appendNumber(message, static_cast<std::size_t>(runId));
+  for (auto const &outcome : outcomes)
+    appendValues(message,
+                 {outcome.m_bhBound ? 1.0 : 0.0,
+                  outcome.m_starBound ? 1.0 : 0.0, outcome.m_semiMajorBh,
+                  outcome.m_semiMajorStar, outcome.m_eccentricityBh,
+                  outcome.m_eccentricityStar});
+  return message;
+}
+
+bool parseOutcome(std::string const &message, std::uint64_t &runId,
+                  std::vector<RunOutcome> &outcomes) {
+  std::vector<double> values;
+  auto const words = splitMessage(message);
+  if (words.size() < 2 || words[0] != OUTCOME ||
+      !parseNumber(words[1], runId) || !parseNumbers(words, 2, values) ||
+      values.size() % VALUES_PER_OUTCOME != 0)
+    return false;
+
+  outcomes.clear();
+  for (auto i = 0u; i < values.size(); i += VALUES_PER_OUTCOME)
+    outcomes.emplace_back(RunOutcome{values[i] != 0.0, values[i + 1] != 0.0,
+                                     values[i + 2], values[i + 3],
+                                     values[i + 4], values[i + 5]});
+  return true;
+}
+
+std::string failedMessage(std::uint64_t runId, std::string const &reason) {
+  std::string message = FAILED;
+  message += ' ';
+  appendNumber(message, static_cast<std::size_t>(runId));
+  message += ' ';
+  message += reason;
+  return message;
+}
+
+bool parseFailed(std::string const &message, std::uint64_t &runId,
+                 std::string &reason) {
+  auto const words = splitMessage(message);
+  if (words.size() < 2 || words[0] != FAILED || !parseNumber(words[1], runId))
+    return false;
+
+  auto const reasonStart = message.find(words[1]) + words[1].size();
+  reason = reasonStart < message.size() ? message.substr(reasonStart + 1)
+                                        : std::string();
+  return true;
+}
+
+std::string doneMessage() { return DONE; }
+
+} // namespace WorkerProtocol
@@ -15,13 +15,14 @@ double XYZComponents::compY() const { return m_yComp; };
 double XYZComponents::compZ() const { return m_zComp; };
 
 double XYZComponents::magnitude() const {
-  return sqrt(pow(m_xComp, 2) + pow(m_yComp, 2) + pow(m_zComp, 2));
+  return sqrt(m_xComp * m_xComp + m_yComp * m_yComp + m_zComp * m_zComp);
 }
 
 double XYZComponents::relativeMag(XYZComponents const &otherXYZ) const {
-  return sqrt(pow(m_xComp - otherXYZ.compX(), 2) +
-              pow(m_yComp - otherXYZ.compY(), 2) +
-              pow(m_zComp - otherXYZ.compZ(), 2));
+  auto const x = m_xComp - otherXYZ.compX();
+  auto const y = m_yComp - otherXYZ.compY();
+  auto const z = m_zComp - otherXYZ.compZ();
+  return sqrt(x * x + y * y + z * z);
 };
 
 XYZComponents XYZComponents::crossProduct(XYZComponents const &otherXYZ) const {
@@ -0,0 +1,260 @@
+#include "Body.h"
+#include "EnergyKernels.h"
+#include "GenerateInitFiles.h"
+#include "InitSimulationParams.h"
+#include "ProcessOutFiles.h"
+#include "RunCostModel.h"
+#include "SimulationBackend.h"
+#include "SimulationParamsStream.h"
+#include "SweepJournal.h"
+#include "SweepPipeline.h"
+
+#include "TaskRunner.h"
+#include "Trajectory.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point const &start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void report(std::string const &stage, std::size_t numberOfRuns,
+            double seconds) {
+  std::printf("%-12s %8zu runs %10.3f s %12.1f runs/s\n", stage.c_str(),
+              numberOfRuns, seconds,
+              seconds > 0.0 ? static_cast<double>(numberOfRuns) / seconds
+                            : 0.0);
+}
+
+SweepDefinition benchmarkSweep(std::size_t numberOfOrientations) {
+  return SweepDefinition({"50", "100", "200"}, {"5", "10", "30"},
+                         {"7", "9", "20"}, numberOfOrientations);
+}
+
+std::vector<InitSimulationParams>
+benchmarkGenerate(InitFileGenerator &initFileGenerator,
+                  SweepDefinition const &sweep) {
+  std::vector<InitSimulationParams> runs;
+  runs.reserve(sweep.numberOfSimulations());
+
+  // Records are handed over from every generator thread at once
+  std::mutex mutex;
+  auto const start = Clock::now();
+  initFileGenerator.generate(
+      sweep, [&runs, &mutex](InitSimulationParams const &parameters,
+                             std::string &&) {
+        std::unique_lock<std::mutex> lock(mutex);
+        runs.emplace_back(parameters);
+      });
+  report("generate", runs.size(), secondsSince(start));
+  return runs;
+}
+
+void benchmarkSimulate(std::string const &directory,
+                       std::vector<InitSimulationParams> const &runs) {
+  std::size_t numberOfFailures = 0;
+  auto const start = Clock::now();
+  {
+    auto const backend = createSimulationBackend(
+        directory, OtherSimulationSettings::numberOfIntegrators(),
+        [&](InitSimulationParams const &parameters,
+            std::string const &outFilename, std::string const &failure,
+            double) {
+          if (failure.empty())
+            std::filesystem::rename(outFilename,
+                                    directory + parameters.filename() + ".out");
+          else
+            ++numberOfFailures;
+        },
+        []() { return true; });
+    for (auto const &parameters : runs)
+      backend->submitRecord(parameters, std::string());
+    backend->waitForAll();
+  }
+  report("simulate", runs.size(), secondsSince(start));
+
+  if (numberOfFailures > 0)
+    throw std::runtime_error(std::to_string(numberOfFailures) +
+                             " mock runs failed.");
+}
+
+// Parsing and aggregation run on a single thread so they can be compared with
+// the per integrator rate of the simulation
+void benchmarkAnalysis(OutFileProcessor &outFileProcessor,
+                       SweepDefinition const &sweep,
+                       std::vector<InitSimulationParams> const &runs) {
+  outFileProcessor.resetResults(sweep);
+  auto parseSeconds = 0.0;
+  auto aggregateSeconds = 0.0;
+  for (auto const &parameters : runs) {
+    auto const parseStart = Clock::now();
+    auto const bodies = outFileProcessor.loadOutFile(parameters);
+    parseSeconds += secondsSince(parseStart);
+
+    auto const aggregateStart = Clock::now();
+    outFileProcessor.recordOutcomes(parameters,
+                                    outFileProcessor.computeOutcomes(bodies));
+    aggregateSeconds += secondsSince(aggregateStart);
+  }
+  report("parse", runs.size(), parseSeconds);
+  report("aggregate", runs.size(), aggregateSeconds);
+
+  // The streamed analysis classifies the runs while parsing them
+  outFileProcessor.resetResults(sweep);
+  auto const streamStart = Clock::now();
+  for (auto const &parameters : runs)
+    outFileProcessor.recordOutcomes(
+        parameters, outFileProcessor.streamOutcomes(parameters));
+  report("streamed", runs.size(), secondsSince(streamStart));
+}
+
+// The vector kernels must reproduce the scalar energies to within this
+// relative error
+double constexpr KERNEL_TOLERANCE = 1e-12;
+
+std::vector<double>
+kernelEnergies(std::vector<std::vector<std::unique_ptr<Body>>> const &runBodies,
+               EnergyKernels::InstructionSet instructionSet, double &seconds) {
+  EnergyKernels::limitInstructionSet(instructionSet);
+  std::vector<double> energies;
+  auto const start = Clock::now();
+  for (auto const &bodies : runBodies) {
+    for (auto planet = 2u; planet < bodies.size(); ++planet) {
+      auto const &target = bodies[planet]->trajectory();
+      auto const first = energies.size();
+      energies.resize(first + target.size());
+      EnergyKernels::totalEnergies(target, bodies[1]->trajectory(), 0,
+                                   target.size(), bodies[planet]->mass(),
+                                   bodies[1]->mass(), energies.data() + first);
+    }
+  }
+  seconds = secondsSince(start);
+  return energies;
+}
+
+// Times the energy kernel of each supported instruction set on the parsed
+// trajectories and checks it against the scalar kernel
+void benchmarkKernels(OutFileProcessor &outFileProcessor,
+                      std::vector<InitSimulationParams> const &runs) {
+  std::vector<std::vector<std::unique_ptr<Body>>> runBodies;
+  runBodies.reserve(runs.size());
+  for (auto const &parameters : runs)
+    runBodies.emplace_back(outFileProcessor.loadOutFile(parameters));
+
+  using EnergyKernels::InstructionSet;
+  auto const supported = EnergyKernels::supportedInstructionSet();
+  auto scalarSeconds = 0.0;
+  auto const scalarEnergies =
+      kernelEnergies(runBodies, InstructionSet::Scalar, scalarSeconds);
+  report("scalar", runs.size(), scalarSeconds);
+
+  for (auto const instructionSet :
+       {InstructionSet::AVX2, InstructionSet::AVX512}) {
+    if (instructionSet > supported)
+      continue;
+    auto seconds = 0.0;
+    auto const energies = kernelEnergies(runBodies, instructionSet, seconds);
+    auto maximumError = 0.0;
+    for (auto i = 0u; i < energies.size(); ++i)
+      maximumError = std::max(maximumError,
+                              std::abs(energies[i] - scalarEnergies[i]) /
+                                  std::abs(scalarEnergies[i]));
+    report(EnergyKernels::instructionSetName(instructionSet), runs.size(),
+           seconds);
+    std::printf("%-12s %8s maximum relative error %g\n", "", "", maximumError);
+
+    if (!(maximumError <= KERNEL_TOLERANCE)) {
+      EnergyKernels::limitInstructionSet(supported);
+      throw std::runtime_error(
+          std::string("The ") +
+          EnergyKernels::instructionSetName(instructionSet) +
+          " energy kernel differs from the scalar kernel.");
+    }
+  }
+  EnergyKernels::limitInstructionSet(supported);
+}
+
+void removeOutFiles(std::string const &directory,
+                    std::vector<InitSimulationParams> const &runs) {
+  for (auto const &parameters : runs)
+    std::remove((directory + parameters.filename() + ".out").c_str());
+}
+
+void benchmarkPipeline(std::string const &directory, SweepJournal &journal,
+                       InitFileGenerator &initFileGenerator,
+                       OutFileProcessor &outFileProcessor,
+                       SweepDefinition const &sweep) {
+  RunCostModel costModel(directory);
+  SweepPipeline pipeline(directory, initFileGenerator, outFileProcessor,
+                         journal, costModel);
+  journal.open(false);
+
+  auto const start = Clock::now();
+  auto const completed = pipeline.run(sweep);
+  report("end-to-end", sweep.numberOfSimulations(), secondsSince(start));
+  journal.close();
+
+  if (!completed)
+    throw std::runtime_error("The pipeline did not complete the sweep.");
+}
+
+} // namespace
+
+/*
+Measures the throughput of each stage of a sweep on the mock integrator, so
+that the cost of generation, parsing and aggregation can be followed without
+NewARC.out:
+  DisruptionOfPlanetarySystemsBenchmark <directory> [orientations] [time steps]
+*/
+int main(int argc, char *argv[]) {
+  if (argc < 2 || argv[1][0] == '\0') {
+    std::cerr << "Usage: " << argv[0]
+              << " <directory> [orientations] [time steps]" << std::endl;
+    return 1;
+  }
+  std::string directory = argv[1];
+  if (directory.back() != '/')
+    directory += '/';
+  auto const numberOfOrientations = argc > 2 ? std::stoul(argv[2]) : 20;
+
+  OtherSimulationSettings::m_integratorBackend = IntegratorBackend::Mock;
+  OtherSimulationSettings::m_mockTimeSteps = argc > 3 ? std::stoul(argv[3]) : 0;
+  OtherSimulationSettings::m_mockLatency = 0;
+  OtherSimulationSettings::m_usePackedFiles = false;
+  OtherSimulationSettings::m_deleteOutFiles = true;
+  OtherSimulationSettings::m_resumeSweep = false;
+
+  try {
+    std::filesystem::create_directories(directory);
+    SweepJournal journal(directory);
+    InitFileGenerator initFileGenerator(directory, journal);
+    OutFileProcessor outFileProcessor(directory, journal);
+    auto const sweep = benchmarkSweep(numberOfOrientations);
+
+    TaskRunner::getInstance().startTask();
+    auto const runs = benchmarkGenerate(initFileGenerator, sweep);
+    benchmarkSimulate(directory, runs);
+    benchmarkAnalysis(outFileProcessor, sweep, runs);
+    benchmarkKernels(outFileProcessor, runs);
+    removeOutFiles(directory, runs);
+    benchmarkPipeline(directory, journal, initFileGenerator, outFileProcessor,
+                      sweep);
+  } catch (std::exception const &error) {
+    std::cerr << "Benchmark stopped: " << error.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
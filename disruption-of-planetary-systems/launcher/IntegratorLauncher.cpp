@@ -0,0 +1,66 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+/*
+Limits its own CPU time and address space, and then replaces itself with an
+integrator, so that the limits hold from the first instruction of the
+integrator. It is started by the integrator scheduler as
+  IntegratorLauncher <CPU seconds> <memory MiB> <integrator>
+where a limit of zero leaves that resource unlimited. A limit which cannot be
+set stops the launcher with LIMIT_FAILURE before the integrator starts.
+*/
+
+namespace {
+
+// Must match the status the integrator scheduler reads as a limit failure
+int constexpr LIMIT_FAILURE = 125;
+
+// The status of a shell which cannot start a command
+int constexpr EXEC_FAILURE = 127;
+
+// The number of bytes in a mebibyte, the unit of the memory limit
+rlim_t constexpr BYTES_PER_MEBIBYTE = 1024 * 1024;
+
+bool setLimit(int resource, rlim_t softLimit, rlim_t hardLimit,
+              char const *name) {
+  rlimit const limit{softLimit, hardLimit};
+  if (setrlimit(resource, &limit) == 0)
+    return true;
+  std::fprintf(stderr, "Failed to limit the %s of the integrator: %s\n", name,
+               std::strerror(errno));
+  return false;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 4) {
+    std::fprintf(stderr,
+                 "Usage: %s <CPU seconds> <memory MiB> <integrator>\n",
+                 argv[0]);
+    return LIMIT_FAILURE;
+  }
+
+  auto const cpuTimeLimit = std::strtoull(argv[1], nullptr, 10);
+  auto const memoryLimit = std::strtoull(argv[2], nullptr, 10);
+
+  // The hard CPU limit lies a second past the soft one, so that SIGXCPU is
+  // sent first
+  if (cpuTimeLimit > 0 &&
+      !setLimit(RLIMIT_CPU, cpuTimeLimit, cpuTimeLimit + 1, "CPU time"))
+    return LIMIT_FAILURE;
+  if (memoryLimit > 0 &&
+      !setLimit(RLIMIT_AS, memoryLimit * BYTES_PER_MEBIBYTE,
+                memoryLimit * BYTES_PER_MEBIBYTE, "address space"))
+    return LIMIT_FAILURE;
+
+  execv(argv[3], argv + 3);
+  std::fprintf(stderr, "Failed to start %s: %s\n", argv[3],
+               std::strerror(errno));
+  return EXEC_FAILURE;
+}
@@ -0,0 +1,46 @@
+#ifndef ALIGNED_ALLOCATOR_H
+#define ALIGNED_ALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+
+/*
+An allocator for standard containers which aligns their storage to the given
+number of bytes, so that their elements can be read with aligned vector loads.
+*/
+template <typename T, std::size_t Alignment> class AlignedAllocator {
+public:
+  using value_type = T;
+
+  template <typename U> struct rebind {
+    using other = AlignedAllocator<U, Alignment>;
+  };
+
+  AlignedAllocator() noexcept {}
+
+  template <typename U>
+  AlignedAllocator(AlignedAllocator<U, Alignment> const &) noexcept {}
+
+  T *allocate(std::size_t size) {
+    return static_cast<T *>(
+        ::operator new(size * sizeof(T), std::align_val_t(Alignment)));
+  }
+
+  void deallocate(T *pointer, std::size_t) noexcept {
+    ::operator delete(pointer, std::align_val_t(Alignment));
+  }
+};
+
+template <typename T, typename U, std::size_t Alignment>
+bool operator==(AlignedAllocator<T, Alignment> const &,
+                AlignedAllocator<U, Alignment> const &) {
+  return true;
+}
+
+template <typename T, typename U, std::size_t Alignment>
+bool operator!=(AlignedAllocator<T, Alignment> const &,
+                AlignedAllocator<U, Alignment> const &) {
+  return false;
+}
+
+#endif /* ALIGNED_ALLOCATOR_H */
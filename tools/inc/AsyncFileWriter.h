@@ -0,0 +1,52 @@
+#ifndef ASYNC_FILE_WRITER_H
+#define ASYNC_FILE_WRITER_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+Writes buffers to disk on a dedicated thread. Buffers are recycled once they
+have been written so that the formatting threads can reuse their capacity.
+*/
+class AsyncFileWriter {
+public:
+  using WriteFunction =
+      std::function<void(std::string const &target, std::string const &text)>;
+
+  AsyncFileWriter(std::size_t maximumQueueSize = 256);
+  AsyncFileWriter(WriteFunction const &writeFunction,
+                  std::size_t maximumQueueSize = 256);
+  ~AsyncFileWriter();
+
+  std::string acquireBuffer();
+  void write(std::string const &target, std::string &&buffer);
+
+  void finish();
+
+private:
+  void run();
+  void writeFile(std::string const &filename, std::string const &text) const;
+
+  WriteFunction m_writeFunction;
+  std::size_t m_maximumQueueSize;
+
+  std::queue<std::pair<std::string, std::string>> m_pending;
+  std::vector<std::string> m_freeBuffers;
+  std::size_t m_writing;
+  std::string m_error;
+
+  // Synchronization
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  bool m_stop;
+
+  std::thread m_worker;
+};
+
+#endif /* ASYNC_FILE_WRITER_H */
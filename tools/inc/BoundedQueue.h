@@ -0,0 +1,83 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <utility>
+
+/*
+A queue with a fixed capacity shared between producer and consumer threads.
+Pushing blocks while the queue is full and popping blocks while it is empty.
+Once closed, pushing fails and popping fails after the queue has drained.
+*/
+template <typename T> class BoundedQueue {
+public:
+  BoundedQueue(std::size_t capacity) : m_capacity(capacity), m_closed(false) {}
+
+  bool push(T &&item) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_notFull.wait(lock,
+                   [&] { return m_closed || m_items.size() < m_capacity; });
+    if (m_closed)
+      return false;
+
+    m_items.push(std::move(item));
+    m_notEmpty.notify_one();
+    return true;
+  }
+
+  bool pop(T &item) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_notEmpty.wait(lock, [&] { return m_closed || !m_items.empty(); });
+    if (m_items.empty())
+      return false;
+
+    item = std::move(m_items.front());
+    m_items.pop();
+    m_notFull.notify_one();
+    return true;
+  }
+
+  // Gives up on an item once the timeout has passed
+  template <typename Rep, typename Period>
+  bool popFor(T &item, std::chrono::duration<Rep, Period> const &timeout) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_notEmpty.wait_for(lock, timeout,
+                        [&] { return m_closed || !m_items.empty(); });
+    if (m_items.empty())
+      return false;
+
+    item = std::move(m_items.front());
+    m_items.pop();
+    m_notFull.notify_one();
+    return true;
+  }
+
+  bool isDrained() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_closed && m_items.empty();
+  }
+
+  void close() {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_closed = true;
+    }
+    m_notFull.notify_all();
+    m_notEmpty.notify_all();
+  }
+
+private:
+  std::size_t m_capacity;
+  std::queue<T> m_items;
+  bool m_closed;
+
+  // Synchronization
+  std::mutex m_mutex;
+  std::condition_variable m_notFull;
+  std::condition_variable m_notEmpty;
+};
+
+#endif /* BOUNDED_QUEUE_H */
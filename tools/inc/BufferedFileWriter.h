@@ -0,0 +1,35 @@
+#ifndef BUFFERED_FILE_WRITER_H
+#define BUFFERED_FILE_WRITER_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/*
+Writes a file through a buffer of its own, so that text can be formatted
+straight into the buffer and written to disk a block at a time rather than
+being built up in memory first. The file is only complete once finish has
+been called.
+*/
+class BufferedFileWriter {
+public:
+  BufferedFileWriter(std::string const &filename,
+                     std::size_t bufferSize = 1 << 20);
+  ~BufferedFileWriter();
+
+  void append(char const *data, std::size_t size);
+  void append(std::string const &text);
+  void append(char character);
+
+  void finish();
+
+private:
+  void flush();
+
+  std::string m_filename;
+  std::FILE *m_file;
+  std::vector<char> m_buffer;
+  std::size_t m_size;
+};
+
+#endif /* BUFFERED_FILE_WRITER_H */
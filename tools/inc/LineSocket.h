@@ -0,0 +1,46 @@
+#ifndef LINE_SOCKET_H
+#define LINE_SOCKET_H
+
+#ifdef __linux__
+
+#include <string>
+
+/*
+A stream socket carrying newline terminated messages. An address is either
+host:port for a TCP socket or unix:path for a Unix domain socket. Received data
+is buffered until a whole line has arrived, so that a socket can be polled and
+read without blocking on a partial message.
+*/
+class LineSocket {
+public:
+  static LineSocket listen(std::string const &address);
+  static LineSocket connect(std::string const &address);
+
+  explicit LineSocket(int descriptor = -1);
+  LineSocket(LineSocket &&otherSocket);
+  LineSocket &operator=(LineSocket &&otherSocket);
+  LineSocket(LineSocket const &) = delete;
+  LineSocket &operator=(LineSocket const &) = delete;
+  ~LineSocket();
+
+  int descriptor() const;
+  bool isOpen() const;
+
+  LineSocket accept() const;
+
+  bool send(std::string const &line) const;
+  bool receive(std::string &line);
+  bool readAvailable();
+  bool nextLine(std::string &line);
+
+  void shutdown() const;
+  void close();
+
+private:
+  int m_descriptor;
+  std::string m_buffer;
+};
+
+#endif /* __linux__ */
+
+#endif /* LINE_SOCKET_H */
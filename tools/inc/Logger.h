@@ -18,8 +18,11 @@
 
   Error: A crucial operation within the code fails via a 'throw' which is
   caught. The programs execution will have been stopped.
+
+  Until a text edit is set, as when running headless, every log other than a
+  debug log is written to stderr instead.
 */
-enum LogType { Debug, Info, Warning, Error } const;
+enum LogType { Debug, Info, Warning, Error };
 
 class Logger {
 
@@ -41,8 +44,10 @@ public:
 private:
   Logger() {} // Singleton
 
-  QTextEdit *m_logger;
-  QSplitter *m_layout;
+  void addStandardErrorLog(LogType const &logType, std::string const &message);
+
+  QTextEdit *m_logger = nullptr;
+  QSplitter *m_layout = nullptr;
   bool m_statusOn = false;
 
   std::mutex m_mutex;
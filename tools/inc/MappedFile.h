@@ -0,0 +1,33 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+/*
+A read-only view of the whole of a file. On POSIX systems the file is mapped
+into memory and paged in as it is read, elsewhere it is read into a buffer. A
+file which could not be opened gives a closed view.
+*/
+class MappedFile {
+public:
+  MappedFile(std::string const &filename);
+  ~MappedFile();
+
+  MappedFile(MappedFile const &) = delete;
+  MappedFile &operator=(MappedFile const &) = delete;
+
+  bool isOpen() const;
+  char const *data() const;
+  std::size_t size() const;
+
+private:
+  bool m_isOpen;
+  char const *m_data;
+  std::size_t m_size;
+#ifdef _WIN32
+  std::string m_buffer;
+#endif
+};
+
+#endif /* MAPPED_FILE_H */
@@ -0,0 +1,68 @@
+#ifndef PACKED_FILE_H
+#define PACKED_FILE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/*
+A packed file stores many named records in a single append-only data file. The
+offset and size of each record is appended to an index file stored alongside
+it, named <filename>.idx. Later records replace earlier records of the same
+name.
+*/
+struct PackedRecord {
+  std::uint64_t m_offset;
+  std::uint64_t m_size;
+};
+
+class PackedFileWriter {
+public:
+  PackedFileWriter(std::string const &filename, bool truncate);
+  ~PackedFileWriter();
+
+  PackedRecord append(std::string const &name, char const *data,
+                      std::size_t size);
+  PackedRecord append(std::string const &name, std::string const &data);
+  PackedRecord appendFile(std::string const &name,
+                          std::string const &filename);
+
+  void flush();
+
+private:
+  std::string m_filename;
+  std::FILE *m_dataFile;
+  std::FILE *m_indexFile;
+  std::uint64_t m_size;
+
+  std::mutex m_mutex;
+};
+
+class PackedFileReader {
+public:
+  PackedFileReader(std::string const &filename);
+  ~PackedFileReader();
+
+  bool contains(std::string const &name) const;
+  std::string read(std::string const &name) const;
+
+private:
+  void loadIndex();
+
+  std::string m_filename;
+  std::FILE *m_dataFile;
+  std::unordered_map<std::string, PackedRecord> m_index;
+
+  mutable std::mutex m_mutex;
+};
+
+namespace PackedFile {
+
+std::string indexFilename(std::string const &filename);
+void remove(std::string const &filename);
+
+} // namespace PackedFile
+
+#endif /* PACKED_FILE_H */
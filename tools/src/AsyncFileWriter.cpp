@@ -0,0 +1,110 @@
+#include "AsyncFileWriter.h"
+
+#include <cstdio>
+#include <stdexcept>
+
+AsyncFileWriter::AsyncFileWriter(std::size_t maximumQueueSize)
+    : AsyncFileWriter(WriteFunction(), maximumQueueSize) {}
+
+AsyncFileWriter::AsyncFileWriter(WriteFunction const &writeFunction,
+                                 std::size_t maximumQueueSize)
+    : m_writeFunction(writeFunction), m_maximumQueueSize(maximumQueueSize),
+      m_writing(0), m_stop(false) {
+  if (!m_writeFunction)
+    m_writeFunction = [this](std::string const &filename,
+                             std::string const &text) {
+      writeFile(filename, text);
+    };
+  m_worker = std::thread([this] { run(); });
+}
+
+AsyncFileWriter::~AsyncFileWriter() {
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_condition.notify_all();
+  m_worker.join();
+}
+
+std::string AsyncFileWriter::acquireBuffer() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (m_freeBuffers.empty())
+    return std::string();
+
+  auto buffer = std::move(m_freeBuffers.back());
+  m_freeBuffers.pop_back();
+  buffer.clear();
+  return buffer;
+}
+
+void AsyncFileWriter::write(std::string const &target, std::string &&buffer) {
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [&] {
+      return m_stop || m_pending.size() < m_maximumQueueSize;
+    });
+    if (m_stop)
+      throw std::runtime_error("The AsyncFileWriter has been stopped.");
+    m_pending.emplace(target, std::move(buffer));
+  }
+  m_condition.notify_all();
+}
+
+void AsyncFileWriter::finish() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_condition.wait(lock, [&] { return m_pending.empty() && m_writing == 0; });
+
+  if (!m_error.empty()) {
+    auto const error = std::move(m_error);
+    m_error.clear();
+    throw std::runtime_error(error);
+  }
+}
+
+void AsyncFileWriter::run() {
+  for (;;) {
+    std::pair<std::string, std::string> item;
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_condition.wait(lock, [&] { return m_stop || !m_pending.empty(); });
+      if (m_stop && m_pending.empty())
+        return;
+      item = std::move(m_pending.front());
+      m_pending.pop();
+      ++m_writing;
+    }
+    m_condition.notify_all();
+
+    std::string error;
+    try {
+      m_writeFunction(item.first, item.second);
+    } catch (std::runtime_error const &exception) {
+      error = exception.what();
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      --m_writing;
+      if (!error.empty() && m_error.empty())
+        m_error = std::move(error);
+      if (m_freeBuffers.size() < m_maximumQueueSize)
+        m_freeBuffers.emplace_back(std::move(item.second));
+    }
+    m_condition.notify_all();
+  }
+}
+
+void AsyncFileWriter::writeFile(std::string const &filename,
+                                std::string const &text) const {
+  auto file = std::fopen(filename.c_str(), "wb");
+  if (!file)
+    throw std::runtime_error(
+        "Failed to open file " + filename +
+        " for writing. Please make sure the file is closed.");
+
+  auto const written = std::fwrite(text.data(), 1, text.size(), file);
+  if (std::fclose(file) != 0 || written != text.size())
+    throw std::runtime_error("Failed to write file " + filename + ".");
+}
@@ -0,0 +1,62 @@
+#include "BufferedFileWriter.h"
+
+#include <cstring>
+#include <stdexcept>
+
+BufferedFileWriter::BufferedFileWriter(std::string const &filename,
+                                       std::size_t bufferSize)
+    : m_filename(filename), m_file(std::fopen(filename.c_str(), "wb")),
+      m_buffer(bufferSize), m_size(0) {
+  if (!m_file)
+    throw std::runtime_error(
+        "Failed to open file " + filename +
+        " for writing. Please make sure the file is closed.");
+  // The buffer is our own, so the stream does not need one as well
+  std::setvbuf(m_file, nullptr, _IONBF, 0);
+}
+
+BufferedFileWriter::~BufferedFileWriter() {
+  if (m_file)
+    std::fclose(m_file);
+}
+
+void BufferedFileWriter::append(char const *data, std::size_t size) {
+  if (m_size + size > m_buffer.size()) {
+    flush();
+    // Data larger than the buffer is written without being copied
+    if (size > m_buffer.size()) {
+      if (std::fwrite(data, 1, size, m_file) != size)
+        throw std::runtime_error("Failed to write file " + m_filename + ".");
+      return;
+    }
+  }
+  std::memcpy(m_buffer.data() + m_size, data, size);
+  m_size += size;
+}
+
+void BufferedFileWriter::append(std::string const &text) {
+  append(text.data(), text.size());
+}
+
+void BufferedFileWriter::append(char character) {
+  if (m_size == m_buffer.size())
+    flush();
+  m_buffer[m_size++] = character;
+}
+
+void BufferedFileWriter::finish() {
+  flush();
+  auto const closed = std::fclose(m_file) == 0;
+  m_file = nullptr;
+  if (!closed)
+    throw std::runtime_error("Failed to write file " + m_filename + ".");
+}
+
+void BufferedFileWriter::flush() {
+  if (!m_file)
+    throw std::runtime_error("The file " + m_filename +
+                             " has already been finished.");
+  if (m_size > 0 && std::fwrite(m_buffer.data(), 1, m_size, m_file) != m_size)
+    throw std::runtime_error("Failed to write file " + m_filename + ".");
+  m_size = 0;
+}
@@ -0,0 +1,221 @@
+#include "LineSocket.h"
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// The number of pending connections a listening socket queues
+int constexpr LISTEN_BACKLOG = 64;
+// The number of bytes read from a socket at a time
+std::size_t constexpr READ_SIZE = 1 << 16;
+
+char constexpr UNIX_PREFIX[] = "unix:";
+
+std::string systemError(std::string const &message) {
+  return message + ": " + std::strerror(errno);
+}
+
+bool isUnixAddress(std::string const &address) {
+  return address.compare(0, sizeof(UNIX_PREFIX) - 1, UNIX_PREFIX) == 0;
+}
+
+sockaddr_un unixAddress(std::string const &address) {
+  auto const path = address.substr(sizeof(UNIX_PREFIX) - 1);
+  sockaddr_un socketAddress{};
+  if (path.empty() || path.size() >= sizeof(socketAddress.sun_path))
+    throw std::runtime_error("The socket path " + path + " is invalid.");
+  socketAddress.sun_family = AF_UNIX;
+  std::strcpy(socketAddress.sun_path, path.c_str());
+  return socketAddress;
+}
+
+// Calls the function with each TCP address the host:port resolves to until
+// it returns a valid descriptor
+template <typename Function>
+int withTcpAddresses(std::string const &address, bool passive,
+                     Function const &function) {
+  auto const separator = address.rfind(':');
+  if (separator == std::string::npos)
+    throw std::runtime_error("The address " + address +
+                             " is not of the form host:port.");
+  auto const host = address.substr(0, separator);
+  auto const port = address.substr(separator + 1);
+
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = passive ? AI_PASSIVE : 0;
+
+  addrinfo *addresses = nullptr;
+  auto const error = getaddrinfo(host.empty() ? nullptr : host.c_str(),
+                                 port.c_str(), &hints, &addresses);
+  if (error != 0)
+    throw std::runtime_error("Failed to resolve " + address + ": " +
+                             gai_strerror(error));
+
+  auto descriptor = -1;
+  for (auto info = addresses; info && descriptor < 0; info = info->ai_next)
+    descriptor = function(info->ai_family, info->ai_addr, info->ai_addrlen);
+  freeaddrinfo(addresses);
+  return descriptor;
+}
+
+int listenOn(int family, sockaddr const *socketAddress, socklen_t length) {
+  auto const descriptor = socket(family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (descriptor < 0)
+    return -1;
+
+  auto const reuse = 1;
+  setsockopt(descriptor, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  if (bind(descriptor, socketAddress, length) != 0 ||
+      ::listen(descriptor, LISTEN_BACKLOG) != 0) {
+    ::close(descriptor);
+    return -1;
+  }
+  return descriptor;
+}
+
+int connectTo(int family, sockaddr const *socketAddress, socklen_t length) {
+  auto const descriptor = socket(family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (descriptor < 0)
+    return -1;
+
+  if (::connect(descriptor, socketAddress, length) != 0) {
+    ::close(descriptor);
+    return -1;
+  }
+  return descriptor;
+}
+
+} // namespace
+
+LineSocket LineSocket::listen(std::string const &address) {
+  auto descriptor = -1;
+  if (isUnixAddress(address)) {
+    auto const socketAddress = unixAddress(address);
+    // A socket file left behind by an earlier coordinator would block bind
+    unlink(socketAddress.sun_path);
+    descriptor = listenOn(AF_UNIX,
+                          reinterpret_cast<sockaddr const *>(&socketAddress),
+                          sizeof(socketAddress));
+  } else {
+    descriptor = withTcpAddresses(address, true, listenOn);
+  }
+
+  if (descriptor < 0)
+    throw std::runtime_error(systemError("Failed to listen on " + address));
+  return LineSocket(descriptor);
+}
+
+LineSocket LineSocket::connect(std::string const &address) {
+  auto descriptor = -1;
+  if (isUnixAddress(address)) {
+    auto const socketAddress = unixAddress(address);
+    descriptor = connectTo(AF_UNIX,
+                           reinterpret_cast<sockaddr const *>(&socketAddress),
+                           sizeof(socketAddress));
+  } else {
+    descriptor = withTcpAddresses(address, false, connectTo);
+  }
+
+  if (descriptor < 0)
+    throw std::runtime_error(systemError("Failed to connect to " + address));
+  return LineSocket(descriptor);
+}
+
+LineSocket::LineSocket(int descriptor) : m_descriptor(descriptor) {}
+
+LineSocket::LineSocket(LineSocket &&otherSocket)
+    : m_descriptor(otherSocket.m_descriptor),
+      m_buffer(std::move(otherSocket.m_buffer)) {
+  otherSocket.m_descriptor = -1;
+}
+
+LineSocket &LineSocket::operator=(LineSocket &&otherSocket) {
+  if (this != &otherSocket) {
+    close();
+    m_descriptor = otherSocket.m_descriptor;
+    m_buffer = std::move(otherSocket.m_buffer);
+    otherSocket.m_descriptor = -1;
+  }
+  return *this;
+}
+
+LineSocket::~LineSocket() { close(); }
+
+int LineSocket::descriptor() const { return m_descriptor; }
+
+bool LineSocket::isOpen() const { return m_descriptor >= 0; }
+
+LineSocket LineSocket::accept() const {
+  auto const descriptor = accept4(m_descriptor, nullptr, nullptr, SOCK_CLOEXEC);
+  if (descriptor < 0 && errno != EINTR && errno != EAGAIN)
+    throw std::runtime_error(systemError("Failed to accept a connection"));
+  return LineSocket(descriptor);
+}
+
+bool LineSocket::send(std::string const &line) const {
+  auto const message = line + "\n";
+  for (std::size_t sent = 0; sent < message.size();) {
+    auto const result = ::send(m_descriptor, message.data() + sent,
+                               message.size() - sent, MSG_NOSIGNAL);
+    if (result < 0 && errno == EINTR)
+      continue;
+    if (result <= 0)
+      return false;
+    sent += static_cast<std::size_t>(result);
+  }
+  return true;
+}
+
+bool LineSocket::receive(std::string &line) {
+  while (!nextLine(line))
+    if (!readAvailable())
+      return false;
+  return true;
+}
+
+bool LineSocket::readAvailable() {
+  char characters[READ_SIZE];
+  auto result = ::recv(m_descriptor, characters, READ_SIZE, 0);
+  while (result < 0 && errno == EINTR)
+    result = ::recv(m_descriptor, characters, READ_SIZE, 0);
+  if (result <= 0)
+    return false;
+  m_buffer.append(characters, static_cast<std::size_t>(result));
+  return true;
+}
+
+bool LineSocket::nextLine(std::string &line) {
+  auto const lineEnd = m_buffer.find('\n');
+  if (lineEnd == std::string::npos)
+    return false;
+  line.assign(m_buffer, 0, lineEnd);
+  m_buffer.erase(0, lineEnd + 1);
+  return true;
+}
+
+// Wakes a thread blocked receiving from the socket, which then sees it closed
+void LineSocket::shutdown() const {
+  if (m_descriptor >= 0)
+    ::shutdown(m_descriptor, SHUT_RDWR);
+}
+
+void LineSocket::close() {
+  if (m_descriptor >= 0) {
+    ::close(m_descriptor);
+    m_descriptor = -1;
+  }
+}
+
+#endif /* __linux__ */
@@ -3,6 +3,8 @@
 // @start-date 04/07/2019
 #include "Logger.h"
 
+#include <iostream>
+
 #include <QList>
 #include <QScrollBar>
 
@@ -34,7 +36,9 @@ void Logger::setVisible(bool visible) {
 void Logger::addLog(LogType const &logType, std::string const &message) {
   std::unique_lock<std::mutex> lock(m_mutex);
 
-  if (m_statusOn) {
+  if (!m_logger) {
+    addStandardErrorLog(logType, message);
+  } else if (m_statusOn) {
     switch (logType) {
     case LogType::Debug:
       m_logger->setTextColor(Qt::black);
@@ -59,6 +63,23 @@ void Logger::addLog(LogType const &logType, std::string const &message) {
   }
 }
 
+void Logger::addStandardErrorLog(LogType const &logType,
+                                 std::string const &message) {
+  switch (logType) {
+  case LogType::Debug:
+    return;
+  case LogType::Info:
+    std::cerr << "Info: " << message << std::endl;
+    return;
+  case LogType::Warning:
+    std::cerr << "Warning: " << message << std::endl;
+    return;
+  case LogType::Error:
+    std::cerr << "Error: " << message << std::endl;
+    return;
+  }
+}
+
 void Logger::addLogs(LogType const &logType,
                      std::vector<std::string> const &messages) {
   for (auto const &message : messages)
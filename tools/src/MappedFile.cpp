@@ -0,0 +1,78 @@
+#include "MappedFile.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(std::string const &filename)
+    : m_isOpen(false), m_data(nullptr), m_size(0) {
+  std::ifstream fileStream(filename, std::ios::binary);
+  if (!fileStream.is_open())
+    return;
+
+  m_buffer.assign(std::istreambuf_iterator<char>(fileStream),
+                  std::istreambuf_iterator<char>());
+  m_isOpen = true;
+  m_data = m_buffer.data();
+  m_size = m_buffer.size();
+}
+
+MappedFile::~MappedFile() {}
+
+#else
+
+MappedFile::MappedFile(std::string const &filename)
+    : m_isOpen(false), m_data(nullptr), m_size(0) {
+  auto const descriptor = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+  if (descriptor < 0)
+    return;
+
+  struct stat status;
+  if (fstat(descriptor, &status) != 0) {
+    ::close(descriptor);
+    throw std::runtime_error("Failed to read the size of " + filename + ": " +
+                             std::strerror(errno));
+  }
+
+  m_isOpen = true;
+  m_size = static_cast<std::size_t>(status.st_size);
+  // An empty file cannot be mapped, and has no data to view
+  if (m_size > 0) {
+    auto const mapping =
+        mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (mapping == MAP_FAILED) {
+      ::close(descriptor);
+      throw std::runtime_error("Failed to map " + filename + ": " +
+                               std::strerror(errno));
+    }
+    madvise(mapping, m_size, MADV_SEQUENTIAL);
+    m_data = static_cast<char const *>(mapping);
+  }
+  // The mapping stays valid once the descriptor is closed
+  ::close(descriptor);
+}
+
+MappedFile::~MappedFile() {
+  if (m_data)
+    munmap(const_cast<char *>(m_data), m_size);
+}
+
+#endif /* _WIN32 */
+
+bool MappedFile::isOpen() const { return m_isOpen; }
+
+char const *MappedFile::data() const { return m_data; }
+
+std::size_t MappedFile::size() const { return m_size; }
@@ -0,0 +1,153 @@
+#include "PackedFile.h"
+
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+std::size_t constexpr COPY_BUFFER_SIZE = 1 << 16;
+
+std::FILE *openFile(std::string const &filename, char const *mode) {
+  auto file = std::fopen(filename.c_str(), mode);
+  if (!file)
+    throw std::runtime_error("Failed to open file " + filename + ".");
+  return file;
+}
+
+// Packed files are expected to grow beyond the range of a long
+int seek(std::FILE *file, std::uint64_t offset, int origin) {
+#ifdef _WIN32
+  return _fseeki64(file, static_cast<__int64>(offset), origin);
+#else
+  return fseeko(file, static_cast<off_t>(offset), origin);
+#endif
+}
+
+std::uint64_t fileSize(std::FILE *file) {
+  seek(file, 0, SEEK_END);
+#ifdef _WIN32
+  return static_cast<std::uint64_t>(_ftelli64(file));
+#else
+  return static_cast<std::uint64_t>(ftello(file));
+#endif
+}
+
+} // namespace
+
+PackedFileWriter::PackedFileWriter(std::string const &filename, bool truncate)
+    : m_filename(filename),
+      m_dataFile(openFile(filename, truncate ? "wb" : "ab")),
+      m_indexFile(
+          openFile(PackedFile::indexFilename(filename), truncate ? "w" : "a")),
+      m_size(fileSize(m_dataFile)) {}
+
+PackedFileWriter::~PackedFileWriter() {
+  std::fclose(m_dataFile);
+  std::fclose(m_indexFile);
+}
+
+PackedRecord PackedFileWriter::append(std::string const &name,
+                                      char const *data, std::size_t size) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  PackedRecord const record{m_size, size};
+  if (std::fwrite(data, 1, size, m_dataFile) != size)
+    throw std::runtime_error("Failed to append " + name + " to " +
+                             m_filename + ".");
+  m_size += size;
+
+  std::fprintf(m_indexFile, "%s %llu %llu\n", name.c_str(),
+               static_cast<unsigned long long>(record.m_offset),
+               static_cast<unsigned long long>(record.m_size));
+  return record;
+}
+
+PackedRecord PackedFileWriter::append(std::string const &name,
+                                      std::string const &data) {
+  return append(name, data.data(), data.size());
+}
+
+PackedRecord PackedFileWriter::appendFile(std::string const &name,
+                                          std::string const &filename) {
+  std::ifstream fileStream(filename, std::ios::binary);
+  if (!fileStream.is_open())
+    throw std::runtime_error("The " + filename + " file does not exist.");
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  PackedRecord record{m_size, 0};
+  std::vector<char> buffer(COPY_BUFFER_SIZE);
+  while (fileStream) {
+    fileStream.read(buffer.data(), buffer.size());
+    auto const count = static_cast<std::size_t>(fileStream.gcount());
+    if (std::fwrite(buffer.data(), 1, count, m_dataFile) != count)
+      throw std::runtime_error("Failed to append " + name + " to " +
+                               m_filename + ".");
+    record.m_size += count;
+  }
+  m_size += record.m_size;
+
+  std::fprintf(m_indexFile, "%s %llu %llu\n", name.c_str(),
+               static_cast<unsigned long long>(record.m_offset),
+               static_cast<unsigned long long>(record.m_size));
+  return record;
+}
+
+void PackedFileWriter::flush() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  std::fflush(m_dataFile);
+  std::fflush(m_indexFile);
+}
+
+PackedFileReader::PackedFileReader(std::string const &filename)
+    : m_filename(filename), m_dataFile(openFile(filename, "rb")) {
+  loadIndex();
+}
+
+PackedFileReader::~PackedFileReader() { std::fclose(m_dataFile); }
+
+void PackedFileReader::loadIndex() {
+  std::ifstream indexStream(PackedFile::indexFilename(m_filename));
+  if (!indexStream.is_open())
+    throw std::runtime_error("The index of " + m_filename +
+                             " does not exist.");
+
+  std::string name;
+  PackedRecord record;
+  while (indexStream >> name >> record.m_offset >> record.m_size)
+    m_index[name] = record;
+}
+
+bool PackedFileReader::contains(std::string const &name) const {
+  return m_index.find(name) != m_index.end();
+}
+
+std::string PackedFileReader::read(std::string const &name) const {
+  auto const iter = m_index.find(name);
+  if (iter == m_index.end())
+    throw std::runtime_error("The " + name + " record does not exist in " +
+                             m_filename + ".");
+
+  std::string data(static_cast<std::size_t>(iter->second.m_size), '\0');
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (seek(m_dataFile, iter->second.m_offset, SEEK_SET) != 0 ||
+      std::fread(&data[0], 1, data.size(), m_dataFile) != data.size())
+    throw std::runtime_error("Failed to read " + name + " from " + m_filename +
+                             ".");
+  return data;
+}
+
+namespace PackedFile {
+
+std::string indexFilename(std::string const &filename) {
+  return filename + ".idx";
+}
+
+void remove(std::string const &filename) {
+  std::remove(filename.c_str());
+  std::remove(indexFilename(filename).c_str());
+}
+
+} // namespace PackedFile